@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AG_AbilityTargetTypes.h"
+
+bool FGameplayAbilityTargetData_WeaponHit::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	FGameplayAbilityTargetData_SingleTargetHit::NetSerialize(Ar, Map, bOutSuccess);
+
+	Ar << ClientTimestamp;
+	Ar.SerializeIntPacked(reinterpret_cast<uint32&>(ShotIndex));
+	Ar.SerializeIntPacked(reinterpret_cast<uint32&>(PelletIndex));
+
+	FocusStart.NetSerialize(Ar, Map, bOutSuccess);
+	AimDirection.NetSerialize(Ar, Map, bOutSuccess);
+
+	return true;
+}
@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Abilities/GameplayAbilityTargetTypes.h"
+#include "AG_AbilityTargetTypes.generated.h"
+
+/**
+ * Hitscan hit predicted by the firing client, with what the server needs to validate it without re-simulating the shot.
+ */
+USTRUCT()
+struct ACTIONGAME_API FGameplayAbilityTargetData_WeaponHit : public FGameplayAbilityTargetData_SingleTargetHit
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Server world time as estimated by the client when the shot was fired */
+	UPROPERTY()
+	float ClientTimestamp = 0.f;
+
+	/** Shot of the activation the hit belongs to, together with the pellet it picks the shot's seeded spread direction */
+	UPROPERTY()
+	int32 ShotIndex = 0;
+
+	UPROPERTY()
+	int32 PelletIndex = 0;
+
+	/** Camera location and unspread aim the shot was fired with, the server re-applies the spread to them */
+	UPROPERTY()
+	FVector_NetQuantize10 FocusStart;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal AimDirection;
+
+	virtual UScriptStruct* GetScriptStruct() const override
+	{
+		return FGameplayAbilityTargetData_WeaponHit::StaticStruct();
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FGameplayAbilityTargetData_WeaponHit> : public TStructOpsTypeTraitsBase2<FGameplayAbilityTargetData_WeaponHit>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
@@ -10,6 +10,11 @@ void UAG_GameplayAbility::ActivateAbility(const FGameplayAbilitySpecHandle Handl
 {
 	Super::ActivateAbility(Handle, ActorInfo, ActivationInfo, TriggerEventData);
 
+	ApplyOngoingEffects(ActorInfo);
+}
+
+void UAG_GameplayAbility::ApplyOngoingEffects(const FGameplayAbilityActorInfo* ActorInfo)
+{
 	FGameplayEffectContextHandle EffectContext = ActorInfo->AbilitySystemComponent->MakeEffectContext();
 
 	for (auto GameplayEffect : OngoingEffectsToApplyOnStart)
@@ -5,10 +5,427 @@
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemBlueprintLibrary.h"
 #include "ActionGameTypes.h"
+#include "ActionGameGameplayTags.h"
 #include "Inventory/ItemActors/WeaponItemActor.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "ActionGameCharacter.h"
 #include "Camera/CameraComponent.h"
+#include "Subsystems/LagCompensationSubsystem.h"
+#include "Subsystems/HitscanSubsystem.h"
+#include "AbilitySystem/AG_AbilityTargetTypes.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "ActionGame.h"
+#include "ActionGameStatics.h"
+#include "AbilitySystem/Components/AG_AbilitySystemComponentBase.h"
+#include "Abilities/Tasks/AbilityTask_PlayMontageAndWait.h"
+#include "Abilities/Tasks/AbilityTask_WaitGameplayEvent.h"
+#include "AbilitySystem/AbilityTasks/AbilityTask_WaitHitscanTrace.h"
+#include "AbilitySystem/AbilityTasks/AbilityTask_AutoFire.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rejected Weapon Hits"), STAT_RejectedWeaponHits, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Shots Sent"), STAT_WeaponShotsSent, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Hit RPCs Sent"), STAT_WeaponHitRPCsSent, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Weapon Hits Batched"), STAT_WeaponHitsBatched, STATGROUP_ActionGame);
+
+void UGA_InventoryCombatAbility::ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData)
+{
+	if (!bUseClientTargetData)
+	{
+		Super::ActivateAbility(Handle, ActorInfo, ActivationInfo, TriggerEventData);
+		return;
+	}
+
+	// The native fire path replaces the Blueprint graph, which would trace and apply damage on its own
+	ApplyOngoingEffects(ActorInfo);
+
+	if (!CommitAbility(Handle, ActorInfo, ActivationInfo))
+	{
+		K2_EndAbility();
+		return;
+	}
+
+	LocalShotIndex = 0;
+	LastValidatedShotIndex = INDEX_NONE;
+	LastValidatedShotTimestamp = 0.f;
+	ValidatedPellets.Reset();
+
+	FireStartTime = GetWorld()->GetTimeSeconds();
+
+	if (IsLocallyControlled())
+	{
+		StartFiring();
+	}
+	else if (ActorInfo->IsNetAuthority())
+	{
+		if (UAbilitySystemComponent* AbilityComponent = GetAbilitySystemComponentFromActorInfo())
+		{
+			TargetDataDelegateHandle = AbilityComponent->AbilityTargetDataSetDelegate(Handle, ActivationInfo.GetActivationPredictionKey()).AddUObject(this, &UGA_InventoryCombatAbility::OnClientTargetDataReceived);
+
+			// Target data can arrive before the activation it belongs to, it then waits in the ability system component's cache
+			AbilityComponent->CallReplicatedTargetDataDelegatesIfSet(Handle, ActivationInfo.GetActivationPredictionKey());
+		}
+	}
+}
+
+void UGA_InventoryCombatAbility::EndAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool bReplicateEndAbility, bool bWasCancelled)
+{
+	if (TargetDataDelegateHandle.IsValid())
+	{
+		if (UAbilitySystemComponent* AbilityComponent = GetAbilitySystemComponentFromActorInfo())
+		{
+			AbilityComponent->AbilityTargetDataSetDelegate(Handle, ActivationInfo.GetActivationPredictionKey()).Remove(TargetDataDelegateHandle);
+		}
+		TargetDataDelegateHandle.Reset();
+	}
+
+	Super::EndAbility(Handle, ActorInfo, ActivationInfo, bReplicateEndAbility, bWasCancelled);
+}
+
+bool UGA_InventoryCombatAbility::ShouldAbilityRespondToEvent(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayEventData* Payload) const
+{
+	// Already activated without the event in the input's RPC batch
+	const UAG_AbilitySystemComponentBase* AbilityComponent = ActorInfo ? Cast<UAG_AbilitySystemComponentBase>(ActorInfo->AbilitySystemComponent.Get()) : nullptr;
+
+	if (AbilityComponent && AbilityComponent->WasBatchActivatedByEvent(GetClass())) return false;
+
+	return Super::ShouldAbilityRespondToEvent(ActorInfo, Payload);
+}
+
+void UGA_InventoryCombatAbility::StartFiring()
+{
+	if (StopFireEventTag.IsValid())
+	{
+		UAbilityTask_WaitGameplayEvent* StopFireTask = UAbilityTask_WaitGameplayEvent::WaitGameplayEvent(this, StopFireEventTag, nullptr, true);
+		StopFireTask->EventReceived.AddDynamic(this, &UGA_InventoryCombatAbility::OnStopFireEventReceived);
+		StopFireTask->ReadyForActivation();
+	}
+
+	if (bAutomaticFire)
+	{
+		UAbilityTask_AutoFire* AutoFireTask = UAbilityTask_AutoFire::AutoFire(this, TraceDistance, TraceType);
+		AutoFireTask->OnShotFired.AddDynamic(this, &UGA_InventoryCombatAbility::OnAutoFireShotFired);
+		AutoFireTask->OnHit.AddDynamic(this, &UGA_InventoryCombatAbility::OnAutoFireShotTraced);
+		AutoFireTask->OnMiss.AddDynamic(this, &UGA_InventoryCombatAbility::OnAutoFireShotTraced);
+		AutoFireTask->ReadyForActivation();
+		return;
+	}
+
+	UAnimMontage* AttackMontage = UActionGameStatics::GetWeaponAttackMontage(GetEquippedWeaponStaticData());
+
+	if (!AttackMontage)
+	{
+		// Traced right away, the ability ends before a deferred trace would resolve
+		FireShot(true);
+		K2_EndAbility();
+		return;
+	}
+
+	UAbilityTask_PlayMontageAndWait* MontageTask = UAbilityTask_PlayMontageAndWait::CreatePlayMontageAndWaitProxy(this, NAME_None, AttackMontage);
+	MontageTask->OnBlendOut.AddDynamic(this, &UGA_InventoryCombatAbility::K2_EndAbility);
+	MontageTask->OnCancelled.AddDynamic(this, &UGA_InventoryCombatAbility::K2_EndAbility);
+	MontageTask->OnInterrupted.AddDynamic(this, &UGA_InventoryCombatAbility::K2_EndAbility);
+	MontageTask->OnCompleted.AddDynamic(this, &UGA_InventoryCombatAbility::K2_EndAbility);
+	MontageTask->ReadyForActivation();
+
+	if (FireEventTag.IsValid())
+	{
+		UAbilityTask_WaitGameplayEvent* FireTask = UAbilityTask_WaitGameplayEvent::WaitGameplayEvent(this, FireEventTag, nullptr, true);
+		FireTask->EventReceived.AddDynamic(this, &UGA_InventoryCombatAbility::OnFireEventReceived);
+		FireTask->ReadyForActivation();
+	}
+	else
+	{
+		FireShot(false);
+	}
+}
+
+void UGA_InventoryCombatAbility::FireShot(bool bTraceImmediately)
+{
+	if (!GetEquippedWeaponItemActor()) return;
+
+	// A shot fired inside the activation's RPC batch resolves before the batch is sent, so its hit goes out with it
+	const UAG_AbilitySystemComponentBase* AbilityComponent = Cast<UAG_AbilitySystemComponentBase>(GetAbilitySystemComponentFromActorInfo());
+
+	bTraceImmediately |= AbilityComponent && AbilityComponent->IsBatchingAbilityRPCs(CurrentSpecHandle);
+
+	const int32 ShotIndex = LocalShotIndex++;
+
+	UAbilityTask_WaitHitscanTrace* TraceTask = UAbilityTask_WaitHitscanTrace::WaitHitscanTrace(this, TraceDistance, TraceType, ShotIndex, bTraceImmediately);
+	TraceTask->OnHit.AddDynamic(this, &UGA_InventoryCombatAbility::OnShotTraced);
+	TraceTask->OnMiss.AddDynamic(this, &UGA_InventoryCombatAbility::OnShotTraced);
+	TraceTask->ReadyForActivation();
+
+	ApplyShotRecoil(ShotIndex);
+}
+
+void UGA_InventoryCombatAbility::OnShotTraced(const FGameplayAbilityTargetDataHandle& TargetData)
+{
+	SendWeaponHitTargetData(TargetData);
+}
+
+void UGA_InventoryCombatAbility::OnAutoFireShotFired(int32 ShotIndex)
+{
+	PlayAttackMontage();
+
+	// After the shot's traces were requested, the kick moves the aim of the next shot
+	ApplyShotRecoil(ShotIndex);
+}
+
+void UGA_InventoryCombatAbility::OnAutoFireShotTraced(int32 ShotIndex, const FGameplayAbilityTargetDataHandle& TargetData)
+{
+	SendWeaponHitTargetData(TargetData);
+}
+
+void UGA_InventoryCombatAbility::OnFireEventReceived(FGameplayEventData Payload)
+{
+	FireShot(false);
+}
+
+void UGA_InventoryCombatAbility::OnStopFireEventReceived(FGameplayEventData Payload)
+{
+	K2_EndAbility();
+}
+
+void UGA_InventoryCombatAbility::PlayAttackMontage()
+{
+	UAbilitySystemComponent* AbilityComponent = GetAbilitySystemComponentFromActorInfo();
+
+	UAnimMontage* AttackMontage = UActionGameStatics::GetWeaponAttackMontage(GetEquippedWeaponStaticData());
+
+	// Automatic fire keeps the montage running rather than restarting it every shot
+	if (!AbilityComponent || !AttackMontage || AbilityComponent->GetCurrentMontage() == AttackMontage) return;
+
+	AbilityComponent->PlayMontage(this, GetCurrentActivationInfo(), AttackMontage, 1.f);
+}
+
+void UGA_InventoryCombatAbility::HandleWeaponHit(const FHitResult& HitResult, bool bValidatedByServer)
+{
+	if (AWeaponItemActor* WeaponItemActor = GetEquippedWeaponItemActor())
+	{
+		WeaponItemActor->PlayWeaponEffects(HitResult);
+	}
+
+	if (bValidatedByServer && GetActorInfo().IsNetAuthority())
+	{
+		ApplyWeaponDamage(HitResult);
+	}
+
+	K2_OnWeaponHit(HitResult, bValidatedByServer);
+}
+
+void UGA_InventoryCombatAbility::ApplyWeaponDamage(const FHitResult& HitResult)
+{
+	UAbilitySystemComponent* TargetAbilityComponent = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(HitResult.GetActor());
+
+	if (!HitResult.bBlockingHit || !TargetAbilityComponent) return;
+
+	const FGameplayEffectSpecHandle EffectSpec = GetWeaponEffectSpec(HitResult);
+
+	if (EffectSpec.IsValid())
+	{
+		TargetAbilityComponent->ApplyGameplayEffectSpecToSelf(*EffectSpec.Data.Get());
+	}
+}
+
+bool UGA_InventoryCombatAbility::IsTriggeredByEvent(FGameplayTag EventTag) const
+{
+	for (const FAbilityTriggerData& Trigger : AbilityTriggers)
+	{
+		if (Trigger.TriggerSource == EGameplayAbilityTriggerSource::GameplayEvent && Trigger.TriggerTag == EventTag)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+FGameplayAbilityTargetData_WeaponHit* UGA_InventoryCombatAbility::MakeWeaponHitTargetData(const FHitscanRequest& Request, const FHitResult& HitResult) const
+{
+	FGameplayAbilityTargetData_WeaponHit* WeaponHit = new FGameplayAbilityTargetData_WeaponHit();
+	WeaponHit->HitResult = HitResult;
+	WeaponHit->ShotIndex = Request.ShotIndex;
+	WeaponHit->PelletIndex = Request.PelletIndex;
+	WeaponHit->FocusStart = Request.FocusStart;
+	WeaponHit->AimDirection = Request.AimDirection;
+	WeaponHit->ClientTimestamp = Request.ShotTimestamp;
+
+	return WeaponHit;
+}
+
+void UGA_InventoryCombatAbility::SendWeaponHitTargetData(const FGameplayAbilityTargetDataHandle& TargetData)
+{
+	UAbilitySystemComponent* AbilityComponent = GetAbilitySystemComponentFromActorInfo();
+
+	if (!AbilityComponent || !IsLocallyControlled() || TargetData.Num() == 0) return;
+
+	INC_DWORD_STAT(STAT_WeaponShotsSent);
+
+	if (!GetActorInfo().IsNetAuthority())
+	{
+		const UAG_AbilitySystemComponentBase* AGAbilityComponent = Cast<UAG_AbilitySystemComponentBase>(AbilityComponent);
+
+		if (AGAbilityComponent && AGAbilityComponent->IsBatchingAbilityRPCs(CurrentSpecHandle))
+		{
+			INC_DWORD_STAT(STAT_WeaponHitsBatched);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_WeaponHitRPCsSent);
+		}
+
+		FScopedPredictionWindow ScopedPrediction(AbilityComponent);
+
+		AbilityComponent->CallServerSetReplicatedTargetData(CurrentSpecHandle, GetCurrentActivationInfo().GetActivationPredictionKey(), TargetData, FGameplayTag(), AbilityComponent->ScopedPredictionKey);
+	}
+
+	for (int32 Index = 0; Index < TargetData.Num(); ++Index)
+	{
+		if (const FHitResult* HitResult = TargetData.Get(Index) ? TargetData.Get(Index)->GetHitResult() : nullptr)
+		{
+			HandleWeaponHit(*HitResult, GetActorInfo().IsNetAuthority());
+		}
+	}
+}
+
+void UGA_InventoryCombatAbility::OnClientTargetDataReceived(const FGameplayAbilityTargetDataHandle& Data, FGameplayTag ApplicationTag)
+{
+	UAbilitySystemComponent* AbilityComponent = GetAbilitySystemComponentFromActorInfo();
+
+	if (!AbilityComponent) return;
+
+	AbilityComponent->ConsumeClientReplicatedTargetData(CurrentSpecHandle, GetCurrentActivationInfo().GetActivationPredictionKey());
+
+	for (int32 Index = 0; Index < Data.Num(); ++Index)
+	{
+		const FGameplayAbilityTargetData* TargetData = Data.Get(Index);
+
+		if (!TargetData || TargetData->GetScriptStruct() != FGameplayAbilityTargetData_WeaponHit::StaticStruct()) continue;
+
+		const FGameplayAbilityTargetData_WeaponHit& WeaponHit = *static_cast<const FGameplayAbilityTargetData_WeaponHit*>(TargetData);
+
+		FHitResult ValidatedHitResult;
+
+		if (ValidateWeaponHit(WeaponHit, ValidatedHitResult))
+		{
+			if (WeaponHit.ShotIndex != LastValidatedShotIndex)
+			{
+				LastValidatedShotIndex = WeaponHit.ShotIndex;
+				LastValidatedShotTimestamp = WeaponHit.ClientTimestamp;
+				ValidatedPellets.Reset();
+			}
+			ValidatedPellets.Add(WeaponHit.PelletIndex);
+
+			HandleWeaponHit(ValidatedHitResult, true);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_RejectedWeaponHits);
+		}
+	}
+}
+
+bool UGA_InventoryCombatAbility::ValidateWeaponHit(const FGameplayAbilityTargetData_WeaponHit& WeaponHit, FHitResult& OutHitResult) const
+{
+	OutHitResult = WeaponHit.HitResult;
+
+	// Replayed or reordered shots and pellets
+	if (WeaponHit.ShotIndex < LastValidatedShotIndex) return false;
+
+	if (WeaponHit.ShotIndex == LastValidatedShotIndex && ValidatedPellets.Contains(WeaponHit.PelletIndex)) return false;
+
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	const float MaxRewindTime = ULagCompensationSubsystem::GetMaxRewindTime();
+
+	if (WeaponHit.ClientTimestamp > Now + MaxRewindTime || WeaponHit.ClientTimestamp < Now - MaxRewindTime * 2.f) return false;
+
+	const AWeaponItemActor* WeaponItemActor = GetEquippedWeaponItemActor();
+	const UWeaponStaticData* WeaponStaticData = GetEquippedWeaponStaticData();
+	const APawn* Pawn = Cast<APawn>(GetAvatarActorFromActorInfo());
+
+	if (!WeaponItemActor || !WeaponStaticData || !Pawn) return false;
+
+	if (WeaponHit.ShotIndex < 0 || WeaponHit.PelletIndex < 0 || WeaponHit.PelletIndex >= FMath::Max(WeaponStaticData->PelletCount, 1)) return false;
+
+	// Shots paced only by the montage have no fire rate to hold them to
+	if (WeaponStaticData->FireRate > 0.f)
+	{
+		// The client started firing about half a round trip before the server activated, so its shots arrive no faster than the fire rate
+		if (WeaponHit.ShotIndex > FMath::FloorToInt((Now - FireStartTime) / WeaponStaticData->FireRate) + FireRateShotSlack) return false;
+
+		// Pellets of one shot share its timestamp, later shots have to be at least the fire interval apart
+		if (LastValidatedShotIndex != INDEX_NONE && WeaponHit.ShotIndex > LastValidatedShotIndex)
+		{
+			const float MinShotTimestamp = LastValidatedShotTimestamp + (WeaponHit.ShotIndex - LastValidatedShotIndex) * WeaponStaticData->FireRate - FireIntervalTolerance;
+
+			if (WeaponHit.ClientTimestamp < MinShotTimestamp) return false;
+		}
+	}
+
+	const FHitResult& HitResult = WeaponHit.HitResult;
+
+	if (FVector::DistSquared(HitResult.TraceStart, WeaponItemActor->GetMuzzleLocation()) > FMath::Square(MaxMuzzleDiscrepancy)) return false;
+
+	// The claimed aim has to match where the server sees the shooter looking and from where
+	if (FVector::DistSquared(WeaponHit.FocusStart, Pawn->GetPawnViewLocation()) > FMath::Square(MaxFocusDiscrepancy)) return false;
+
+	if ((WeaponHit.AimDirection | Pawn->GetBaseAimRotation().Vector()) < FMath::Cos(FMath::DegreesToRadians(MaxAimDiscrepancy))) return false;
+
+	// The pellet's direction is not sent, the server applies the shot's seeded spread itself and the muzzle trace must head for a point along it
+	const FVector SpreadDirection = UActionGameStatics::GetWeaponSpreadDirection(WeaponStaticData, WeaponHit.AimDirection, GetShotSeed(WeaponHit.ShotIndex), WeaponHit.PelletIndex);
+
+	FVector FocusPoint, WeaponPoint;
+	FMath::SegmentDistToSegmentSafe(WeaponHit.FocusStart, WeaponHit.FocusStart + SpreadDirection * TraceDistance, HitResult.TraceStart, HitResult.TraceEnd, FocusPoint, WeaponPoint);
+
+	if (FVector::DistSquared(FocusPoint, WeaponPoint) > FMath::Square(SpreadTolerance)) return false;
+
+	if (!HitResult.bBlockingHit) return true;
+
+	const AActor* HitActor = HitResult.GetActor();
+
+	ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>();
+
+	const FVector TraceDirection = (HitResult.Location - HitResult.TraceStart).GetSafeNormal();
+
+	if (!HitActor || !HitActor->IsA<AActionGameCharacter>() || !LagCompensation || !ULagCompensationSubsystem::IsLagCompensationEnabled())
+	{
+		// Nothing to rewind, the server's own trace against the world as it is now has to find the claimed surface
+		static const FName ValidateTraceName = TEXT("ValidateWeaponHit");
+
+		// Same query as the client's muzzle trace, the surface's physical material picks the impact effects
+		FCollisionQueryParams QueryParams(ValidateTraceName, false, GetAvatarActorFromActorInfo());
+		QueryParams.bReturnPhysicalMaterial = true;
+
+		FHitResult CurrentHitResult;
+
+		if (!GetWorld()->LineTraceSingleByChannel(CurrentHitResult, HitResult.TraceStart, HitResult.Location + TraceDirection * HitTolerance, UEngineTypes::ConvertToCollisionChannel(TraceType), QueryParams)) return false;
+
+		if (CurrentHitResult.GetActor() != HitActor) return false;
+
+		if (FVector::DistSquared(CurrentHitResult.Location, HitResult.Location) > FMath::Square(HitTolerance)) return false;
+
+		OutHitResult = CurrentHitResult;
+
+		return true;
+	}
+
+	// The shooter's clock says when they fired, the characters on their screen were another half round trip behind
+	const APlayerState* PlayerState = GetActionGameCharacterFromActorInfo()->GetPlayerState();
+	const float HalfRoundTripTime = PlayerState ? PlayerState->GetPingInMilliseconds() * 0.0005f : 0.f;
+	const float RewindTimestamp = FMath::Max(WeaponHit.ClientTimestamp - HalfRoundTripTime, Now - MaxRewindTime);
+
+	FHitResult RewoundHitResult;
+
+	if (!LagCompensation->LineTraceRewound(HitResult.TraceStart, HitResult.Location + TraceDirection * HitTolerance, RewindTimestamp, GetAvatarActorFromActorInfo(), RewoundHitResult)) return false;
+
+	if (RewoundHitResult.GetActor() != HitActor) return false;
+
+	// The server's own hit against the rewound pose, with the surface and bone it found
+	OutHitResult = RewoundHitResult;
+
+	return true;
+}
 
 FGameplayEffectSpecHandle UGA_InventoryCombatAbility::GetWeaponEffectSpec(const FHitResult& InHitResult)
 {
@@ -20,7 +437,7 @@ FGameplayEffectSpecHandle UGA_InventoryCombatAbility::GetWeaponEffectSpec(const
 
 			FGameplayEffectSpecHandle OutSpec = AbilityComponent->MakeOutgoingSpec(WeaponStaticData->DamageEffect, 1, EffectContext);
 
-			UAbilitySystemBlueprintLibrary::AssignTagSetByCallerMagnitude(OutSpec, FGameplayTag::RequestGameplayTag(TEXT("Attribute.Health")), -WeaponStaticData->BaseDamage);
+			UAbilitySystemBlueprintLibrary::AssignTagSetByCallerMagnitude(OutSpec, FActionGameGameplayTags::Get().AttributeHealthTag, -WeaponStaticData->BaseDamage);
 
 			return OutSpec;
 		}
@@ -52,3 +469,48 @@ const bool UGA_InventoryCombatAbility::GetWeaponToFocusTraceResult(float TraceDi
 
 	return OutHitResult.bBlockingHit;
 }
+
+bool UGA_InventoryCombatAbility::MakeHitscanRequest(float TraceDistance, ETraceTypeQuery TraceType, FHitscanRequest& OutRequest, int32 ShotIndex, int32 PelletIndex)
+{
+	AWeaponItemActor* WeaponItemActor = GetEquippedWeaponItemActor();
+
+	AActionGameCharacter* AActionGameCharacter = GetActionGameCharacterFromActorInfo();
+
+	if (!WeaponItemActor || !AActionGameCharacter) return false;
+
+	const FTransform& CameraTransform = AActionGameCharacter->GetFollowCamera()->GetComponentTransform();
+
+	OutRequest.FocusStart = CameraTransform.GetLocation();
+	OutRequest.AimDirection = CameraTransform.GetRotation().Vector();
+	OutRequest.FocusEnd = CameraTransform.GetLocation() + UActionGameStatics::GetWeaponSpreadDirection(WeaponItemActor->GetWeaponStaticData(), OutRequest.AimDirection, GetShotSeed(ShotIndex), PelletIndex) * TraceDistance;
+	OutRequest.ShotIndex = ShotIndex;
+	OutRequest.PelletIndex = PelletIndex;
+	OutRequest.MuzzleLocation = WeaponItemActor->GetMuzzleLocation();
+	OutRequest.TraceDistance = TraceDistance;
+	OutRequest.TraceChannel = UEngineTypes::ConvertToCollisionChannel(TraceType);
+	OutRequest.Shooter = AActionGameCharacter;
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	OutRequest.ShotTimestamp = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+	return true;
+}
+
+int32 UGA_InventoryCombatAbility::GetShotSeed(int32 ShotIndex) const
+{
+	return UActionGameStatics::MakeShotSeed(GetCurrentActivationInfo().GetActivationPredictionKey(), ShotIndex);
+}
+
+void UGA_InventoryCombatAbility::ApplyShotRecoil(int32 ShotIndex)
+{
+	APawn* Pawn = Cast<APawn>(GetAvatarActorFromActorInfo());
+
+	if (!Pawn || !IsLocallyControlled()) return;
+
+	const FRotator Recoil = UActionGameStatics::GetWeaponRecoil(GetEquippedWeaponStaticData(), ShotIndex, GetShotSeed(ShotIndex));
+
+	if (AController* Controller = Pawn->GetController())
+	{
+		Controller->SetControlRotation(Controller->GetControlRotation() + Recoil);
+	}
+}
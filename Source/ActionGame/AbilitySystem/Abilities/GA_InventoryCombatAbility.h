@@ -6,19 +6,158 @@
 #include "GA_InventoryAbility.h"
 #include "GA_InventoryCombatAbility.generated.h"
 
+struct FHitscanRequest;
+struct FGameplayAbilityTargetData_WeaponHit;
+
 /**
- * 
+ * Fire abilities that send their own hits as target data run a native fire path instead of their Blueprint graph.
+ * Blueprint subclasses opt in per class, from the editor or from their section in DefaultGame.ini.
  */
-UCLASS()
+UCLASS(Config = Game)
 class ACTIONGAME_API UGA_InventoryCombatAbility : public UGA_InventoryAbility
 {
 	GENERATED_BODY()
 
 public:
+	virtual void ActivateAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, const FGameplayEventData* TriggerEventData) override;
+
+	virtual void EndAbility(const FGameplayAbilitySpecHandle Handle, const FGameplayAbilityActorInfo* ActorInfo, const FGameplayAbilityActivationInfo ActivationInfo, bool bReplicateEndAbility, bool bWasCancelled) override;
+
+	virtual bool ShouldAbilityRespondToEvent(const FGameplayAbilityActorInfo* ActorInfo, const FGameplayEventData* Payload) const override;
+
 	UFUNCTION(BlueprintPure)
 	FGameplayEffectSpecHandle GetWeaponEffectSpec(const FHitResult& InHitResult);
 
 	UFUNCTION(BlueprintPure)
 	const bool GetWeaponToFocusTraceResult(float TraceDistance, ETraceTypeQuery TraceType, FHitResult& OutHitResult);
+
+	/** Fills in a batched hitscan request for one pellet of a shot from the equipped weapon, spread by the shot seed */
+	bool MakeHitscanRequest(float TraceDistance, ETraceTypeQuery TraceType, FHitscanRequest& OutRequest, int32 ShotIndex = 0, int32 PelletIndex = 0);
+
+	/** Seed of a shot in this activation, the predicting client and the server agree on it without sending it */
+	UFUNCTION(BlueprintPure)
+	int32 GetShotSeed(int32 ShotIndex) const;
+
+	/** Kicks the local controller's aim by the weapon's recoil for the shot, the native fire path applies it after every shot */
+	UFUNCTION(BlueprintCallable)
+	void ApplyShotRecoil(int32 ShotIndex);
+
+	/** Target data for one traced pellet, carrying what the server needs to recompute the pellet's direction */
+	FGameplayAbilityTargetData_WeaponHit* MakeWeaponHitTargetData(const FHitscanRequest& Request, const FHitResult& HitResult) const;
+
+	/**
+	 * Sends the locally traced pellets of a shot to the server as target data, batched with the activation when possible.
+	 * Each hit is passed to OnWeaponHit locally right away and again on the server once it passes validation.
+	 */
+	UFUNCTION(BlueprintCallable)
+	void SendWeaponHitTargetData(const FGameplayAbilityTargetDataHandle& TargetData);
+
+	bool UsesClientTargetData() const { return bUseClientTargetData; }
+
+	bool IsTriggeredByEvent(FGameplayTag EventTag) const;
+
+protected:
+	UFUNCTION(BlueprintImplementableEvent, DisplayName = "On Weapon Hit")
+	void K2_OnWeaponHit(const FHitResult& HitResult, bool bValidatedByServer);
+
+	void OnClientTargetDataReceived(const FGameplayAbilityTargetDataHandle& Data, FGameplayTag ApplicationTag);
+
+	/** Checks a hit sent by the owning client, OutHitResult is the server's retrace of it, against the rewound pose for characters */
+	bool ValidateWeaponHit(const FGameplayAbilityTargetData_WeaponHit& WeaponHit, FHitResult& OutHitResult) const;
+
+	/** Starts the locally controlled fire loop of the native fire path */
+	void StartFiring();
+
+	/** Traces one shot from the equipped weapon through the hitscan subsystem and sends its hit to the server */
+	void FireShot(bool bTraceImmediately);
+
+	UFUNCTION()
+	void OnShotTraced(const FGameplayAbilityTargetDataHandle& TargetData);
+
+	UFUNCTION()
+	void OnAutoFireShotFired(int32 ShotIndex);
+
+	UFUNCTION()
+	void OnAutoFireShotTraced(int32 ShotIndex, const FGameplayAbilityTargetDataHandle& TargetData);
+
+	/** Plays the effects of a hit, and applies its damage once the server has validated it */
+	void HandleWeaponHit(const FHitResult& HitResult, bool bValidatedByServer);
+
+	void ApplyWeaponDamage(const FHitResult& HitResult);
+
+	void PlayAttackMontage();
+
+	UFUNCTION()
+	void OnFireEventReceived(FGameplayEventData Payload);
+
+	UFUNCTION()
+	void OnStopFireEventReceived(FGameplayEventData Payload);
+
+	/**
+	 * Trust hits traced by the owning client and validate them on the server instead of tracing again.
+	 * The ability then fires natively, so its activation can be RPC batched with the first shot's target data.
+	 */
+	UPROPERTY(EditDefaultsOnly, Config, Category = "Networking")
+	bool bUseClientTargetData = false;
+
+	/** Furthest the claimed trace start may be from the server's muzzle location */
+	UPROPERTY(EditDefaultsOnly, Category = "Networking", meta = (EditCondition = "bUseClientTargetData"))
+	float MaxMuzzleDiscrepancy = 200.f;
+
+	/** How far the server's retrace may land from the claimed hit, around the rewound capsule for characters */
+	UPROPERTY(EditDefaultsOnly, Category = "Networking", meta = (EditCondition = "bUseClientTargetData"))
+	float HitTolerance = 30.f;
+
+	/** Furthest the claimed camera location may be from the shooter's view location, covers the camera boom */
+	UPROPERTY(EditDefaultsOnly, Category = "Networking", meta = (EditCondition = "bUseClientTargetData"))
+	float MaxFocusDiscrepancy = 600.f;
+
+	/** Largest angle in degrees between the claimed aim and the shooter's aim on the server */
+	UPROPERTY(EditDefaultsOnly, Category = "Networking", meta = (EditCondition = "bUseClientTargetData"))
+	float MaxAimDiscrepancy = 10.f;
+
+	/** Closest the muzzle trace has to pass to the recomputed spread direction, covers quantization of the sent vectors */
+	UPROPERTY(EditDefaultsOnly, Category = "Networking", meta = (EditCondition = "bUseClientTargetData"))
+	float SpreadTolerance = 10.f;
+
+	/** Shots a client may run ahead of the fire rate counted from the server's activation, covers jitter in when shots arrive */
+	UPROPERTY(EditDefaultsOnly, Category = "Networking", meta = (EditCondition = "bUseClientTargetData"))
+	int32 FireRateShotSlack = 2;
+
+	/** Seconds two shots' timestamps may come closer than the fire interval, covers corrections of the client's server clock */
+	UPROPERTY(EditDefaultsOnly, Category = "Networking", meta = (EditCondition = "bUseClientTargetData"))
+	float FireIntervalTolerance = 0.05f;
+
+	/** Keep firing at the weapon's fire rate through the auto fire scheduler until the stop fire event arrives */
+	UPROPERTY(EditDefaultsOnly, Config, Category = "Fire", meta = (EditCondition = "bUseClientTargetData"))
+	bool bAutomaticFire = false;
+
+	/** Sent by the attack montage when a single shot leaves the barrel, the shot fires on activation when unset */
+	UPROPERTY(EditDefaultsOnly, Config, Category = "Fire", meta = (EditCondition = "bUseClientTargetData"))
+	FGameplayTag FireEventTag;
+
+	UPROPERTY(EditDefaultsOnly, Config, Category = "Fire", meta = (EditCondition = "bUseClientTargetData"))
+	FGameplayTag StopFireEventTag;
+
+	UPROPERTY(EditDefaultsOnly, Config, Category = "Fire", meta = (EditCondition = "bUseClientTargetData"))
+	float TraceDistance = 10000.f;
+
+	UPROPERTY(EditDefaultsOnly, Config, Category = "Fire", meta = (EditCondition = "bUseClientTargetData"))
+	TEnumAsByte<ETraceTypeQuery> TraceType = TraceTypeQuery3;
+
+	/** Next shot of a single fire activation, automatic fire takes its shot indices from the auto fire scheduler */
+	int32 LocalShotIndex = 0;
+
+	int32 LastValidatedShotIndex = INDEX_NONE;
+
+	/** Server time the activation started, validated shots cannot outpace the fire rate from then on */
+	float FireStartTime = 0.f;
+
+	float LastValidatedShotTimestamp = 0.f;
+
+	/** Pellets of the last validated shot already accepted */
+	TArray<int32, TInlineAllocator<8>> ValidatedPellets;
+
+	FDelegateHandle TargetDataDelegateHandle;
 	
 };
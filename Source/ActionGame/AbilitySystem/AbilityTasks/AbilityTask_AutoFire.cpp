@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AbilityTask_AutoFire.h"
+#include "AbilitySystem/Abilities/GA_InventoryCombatAbility.h"
+#include "ActionGameTypes.h"
+#include "Subsystems/AutoFireSubsystem.h"
+#include "Subsystems/HitscanSubsystem.h"
+#include "AbilitySystem/AG_AbilityTargetTypes.h"
+#include "AbilitySystem/Components/AG_AbilitySystemComponentBase.h"
+
+UAbilityTask_AutoFire* UAbilityTask_AutoFire::AutoFire(UGameplayAbility* OwningAbility, float TraceDistance, ETraceTypeQuery TraceType)
+{
+	UAbilityTask_AutoFire* Task = NewAbilityTask<UAbilityTask_AutoFire>(OwningAbility);
+	Task->TraceDistance = TraceDistance;
+	Task->TraceType = TraceType;
+
+	return Task;
+}
+
+void UAbilityTask_AutoFire::Activate()
+{
+	Super::Activate();
+
+	UGA_InventoryCombatAbility* CombatAbility = Cast<UGA_InventoryCombatAbility>(Ability);
+	const UWeaponStaticData* WeaponData = CombatAbility ? CombatAbility->GetEquippedWeaponStaticData() : nullptr;
+	UAutoFireSubsystem* AutoFire = GetWorld()->GetSubsystem<UAutoFireSubsystem>();
+
+	// Cooldowns are tracked per weapon instance, so swapping weapons does not inherit the previous one's.
+	// AutoFireId is set before the first shot, so ending the task from that shot stops the trigger.
+	if (!WeaponData || !AutoFire || !AutoFire->StartAutoFire(CombatAbility->GetEquippedItemInstance(), WeaponData->FireRate, FOnAutoFireShot::CreateUObject(this, &UAbilityTask_AutoFire::OnShot), AutoFireId))
+	{
+		EndTask();
+	}
+}
+
+void UAbilityTask_AutoFire::OnDestroy(bool bInOwnerFinished)
+{
+	if (AutoFireId != 0)
+	{
+		if (UAutoFireSubsystem* AutoFire = GetWorld()->GetSubsystem<UAutoFireSubsystem>())
+		{
+			AutoFire->StopAutoFire(AutoFireId);
+		}
+
+		AutoFireId = 0;
+	}
+
+	if (UHitscanSubsystem* Hitscan = GetWorld()->GetSubsystem<UHitscanSubsystem>())
+	{
+		for (const uint32 RequestId : PendingRequestIds)
+		{
+			Hitscan->CancelShot(RequestId);
+		}
+	}
+
+	PendingRequestIds.Reset();
+	PendingShots.Reset();
+
+	Super::OnDestroy(bInOwnerFinished);
+}
+
+void UAbilityTask_AutoFire::OnShot(int32 ShotIndex, double ShotTime)
+{
+	UGA_InventoryCombatAbility* CombatAbility = Cast<UGA_InventoryCombatAbility>(Ability);
+	UHitscanSubsystem* Hitscan = GetWorld()->GetSubsystem<UHitscanSubsystem>();
+
+	const UWeaponStaticData* WeaponData = CombatAbility ? CombatAbility->GetEquippedWeaponStaticData() : nullptr;
+
+	if (!WeaponData || !Hitscan) return;
+
+	const UAG_AbilitySystemComponentBase* AbilityComponent = Cast<UAG_AbilitySystemComponentBase>(AbilitySystemComponent.Get());
+
+	const bool bTraceImmediately = AbilityComponent && AbilityComponent->IsBatchingAbilityRPCs(CombatAbility->GetCurrentAbilitySpecHandle());
+
+	const int32 PelletCount = FMath::Max(WeaponData->PelletCount, 1);
+
+	PendingShots.Add(ShotIndex).PendingPellets = PelletCount;
+
+	for (int32 PelletIndex = 0; PelletIndex < PelletCount; ++PelletIndex)
+	{
+		FHitscanRequest Request;
+
+		if (!CombatAbility->MakeHitscanRequest(TraceDistance, TraceType, Request, ShotIndex, PelletIndex))
+		{
+			PendingShots.Remove(ShotIndex);
+			return;
+		}
+
+		// Shots due earlier in the frame are stamped with the time they were due, the server rewinds that much further
+		Request.ShotTimestamp -= GetWorld()->GetTimeSeconds() - ShotTime;
+
+		if (bTraceImmediately)
+		{
+			FHitResult HitResult;
+			Hitscan->ResolveShotNow(Request, HitResult);
+
+			AddPelletResult(Request, HitResult);
+			continue;
+		}
+
+		Request.OnCompleted.BindUObject(this, &UAbilityTask_AutoFire::OnTraceCompleted);
+
+		const uint32 RequestId = Hitscan->RequestShot(MoveTemp(Request));
+
+		if (RequestId != 0)
+		{
+			PendingRequestIds.Add(RequestId);
+		}
+		else if (FPendingShot* PendingShot = PendingShots.Find(ShotIndex))
+		{
+			--PendingShot->PendingPellets;
+		}
+	}
+
+	// Recoil applied from here moves the aim of the next shot, not the one just traced
+	if (ShouldBroadcastAbilityTaskDelegates())
+	{
+		OnShotFired.Broadcast(ShotIndex);
+	}
+
+	const FPendingShot* PendingShot = PendingShots.Find(ShotIndex);
+
+	if (PendingShot && PendingShot->PendingPellets <= 0)
+	{
+		BroadcastShot(ShotIndex);
+	}
+}
+
+void UAbilityTask_AutoFire::OnTraceCompleted(uint32 RequestId, const FHitscanRequest& Request, const FHitResult& HitResult)
+{
+	PendingRequestIds.Remove(RequestId);
+
+	AddPelletResult(Request, HitResult);
+
+	const FPendingShot* PendingShot = PendingShots.Find(Request.ShotIndex);
+
+	if (PendingShot && PendingShot->PendingPellets <= 0)
+	{
+		BroadcastShot(Request.ShotIndex);
+	}
+}
+
+void UAbilityTask_AutoFire::AddPelletResult(const FHitscanRequest& Request, const FHitResult& HitResult)
+{
+	UGA_InventoryCombatAbility* CombatAbility = Cast<UGA_InventoryCombatAbility>(Ability);
+	FPendingShot* PendingShot = PendingShots.Find(Request.ShotIndex);
+
+	if (!CombatAbility || !PendingShot) return;
+
+	PendingShot->TargetData.Add(CombatAbility->MakeWeaponHitTargetData(Request, HitResult));
+	PendingShot->bAnyPelletHit |= HitResult.bBlockingHit;
+	--PendingShot->PendingPellets;
+}
+
+void UAbilityTask_AutoFire::BroadcastShot(int32 ShotIndex)
+{
+	FPendingShot PendingShot;
+
+	if (!PendingShots.RemoveAndCopyValue(ShotIndex, PendingShot) || PendingShot.TargetData.Num() == 0) return;
+
+	if (ShouldBroadcastAbilityTaskDelegates())
+	{
+		if (PendingShot.bAnyPelletHit)
+		{
+			OnHit.Broadcast(ShotIndex, PendingShot.TargetData);
+		}
+		else
+		{
+			OnMiss.Broadcast(ShotIndex, PendingShot.TargetData);
+		}
+	}
+}
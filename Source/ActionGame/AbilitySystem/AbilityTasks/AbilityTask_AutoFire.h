@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Abilities/Tasks/AbilityTask.h"
+#include "Abilities/GameplayAbilityTargetTypes.h"
+#include "Engine/EngineTypes.h"
+#include "AbilityTask_AutoFire.generated.h"
+
+struct FHitscanRequest;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FAutoFireShotDelegate, int32, ShotIndex);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FAutoFireHitDelegate, int32, ShotIndex, const FGameplayAbilityTargetDataHandle&, TargetData);
+
+/**
+ * Fires the equipped weapon at its fire rate until the task ends, through the auto fire scheduler.
+ * Every shot goes through the frame batched hitscan subsystem and is stamped with the sub-frame time it was fired, for the server to rewind to.
+ * Shots fired while the ability's RPCs are being batched resolve immediately, so their hits can join the batch.
+ * The pellets of a shot are reported together as weapon hit target data, OnHit when any of them hit something.
+ */
+UCLASS()
+class ACTIONGAME_API UAbilityTask_AutoFire : public UAbilityTask
+{
+	GENERATED_BODY()
+
+public:
+	/** Broadcast once the shot's pellets are on their way, they report through OnHit and OnMiss once traced */
+	UPROPERTY(BlueprintAssignable)
+	FAutoFireShotDelegate OnShotFired;
+
+	UPROPERTY(BlueprintAssignable)
+	FAutoFireHitDelegate OnHit;
+
+	UPROPERTY(BlueprintAssignable)
+	FAutoFireHitDelegate OnMiss;
+
+	UFUNCTION(BlueprintCallable, Category = "Ability|Tasks", meta = (HidePin = "OwningAbility", DefaultToSelf = "OwningAbility", BlueprintInternalUseOnly = "TRUE"))
+	static UAbilityTask_AutoFire* AutoFire(UGameplayAbility* OwningAbility, float TraceDistance, ETraceTypeQuery TraceType);
+
+	virtual void Activate() override;
+
+protected:
+	virtual void OnDestroy(bool bInOwnerFinished) override;
+
+	void OnShot(int32 ShotIndex, double ShotTime);
+
+	void OnTraceCompleted(uint32 RequestId, const FHitscanRequest& Request, const FHitResult& HitResult);
+
+	void AddPelletResult(const FHitscanRequest& Request, const FHitResult& HitResult);
+
+	void BroadcastShot(int32 ShotIndex);
+
+	float TraceDistance = 0.f;
+
+	TEnumAsByte<ETraceTypeQuery> TraceType;
+
+	uint32 AutoFireId = 0;
+
+	struct FPendingShot
+	{
+		FGameplayAbilityTargetDataHandle TargetData;
+
+		int32 PendingPellets = 0;
+
+		bool bAnyPelletHit = false;
+	};
+
+	/** Hitscan requests still in flight */
+	TSet<uint32> PendingRequestIds;
+
+	/** Shots with pellets still in flight, keyed by shot index */
+	TMap<int32, FPendingShot> PendingShots;
+};
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AbilityTask_WaitHitscanTrace.h"
+#include "AbilitySystem/Abilities/GA_InventoryCombatAbility.h"
+#include "AbilitySystem/AG_AbilityTargetTypes.h"
+#include "ActionGameTypes.h"
+#include "Subsystems/HitscanSubsystem.h"
+
+UAbilityTask_WaitHitscanTrace* UAbilityTask_WaitHitscanTrace::WaitHitscanTrace(UGameplayAbility* OwningAbility, float TraceDistance, ETraceTypeQuery TraceType, int32 ShotIndex, bool bTraceImmediately)
+{
+	UAbilityTask_WaitHitscanTrace* Task = NewAbilityTask<UAbilityTask_WaitHitscanTrace>(OwningAbility);
+	Task->TraceDistance = TraceDistance;
+	Task->TraceType = TraceType;
+	Task->ShotIndex = ShotIndex;
+	Task->bTraceImmediately = bTraceImmediately;
+
+	return Task;
+}
+
+void UAbilityTask_WaitHitscanTrace::Activate()
+{
+	Super::Activate();
+
+	UGA_InventoryCombatAbility* CombatAbility = Cast<UGA_InventoryCombatAbility>(Ability);
+	const UWeaponStaticData* WeaponData = CombatAbility ? CombatAbility->GetEquippedWeaponStaticData() : nullptr;
+	UHitscanSubsystem* Hitscan = GetWorld()->GetSubsystem<UHitscanSubsystem>();
+
+	const int32 PelletCount = WeaponData && Hitscan ? FMath::Max(WeaponData->PelletCount, 1) : 0;
+
+	for (int32 PelletIndex = 0; PelletIndex < PelletCount; ++PelletIndex)
+	{
+		FHitscanRequest Request;
+
+		if (!CombatAbility->MakeHitscanRequest(TraceDistance, TraceType, Request, ShotIndex, PelletIndex)) break;
+
+		if (bTraceImmediately)
+		{
+			FHitResult HitResult;
+			Hitscan->ResolveShotNow(Request, HitResult);
+
+			bAnyPelletHit |= HitResult.bBlockingHit;
+			ShotTargetData.Add(CombatAbility->MakeWeaponHitTargetData(Request, HitResult));
+			continue;
+		}
+
+		Request.OnCompleted.BindUObject(this, &UAbilityTask_WaitHitscanTrace::OnTraceCompleted);
+
+		const uint32 RequestId = Hitscan->RequestShot(MoveTemp(Request));
+
+		if (RequestId != 0)
+		{
+			PendingRequestIds.Add(RequestId);
+		}
+	}
+
+	if (PendingRequestIds.Num() == 0)
+	{
+		BroadcastShot();
+	}
+}
+
+void UAbilityTask_WaitHitscanTrace::OnDestroy(bool bInOwnerFinished)
+{
+	if (UHitscanSubsystem* Hitscan = GetWorld()->GetSubsystem<UHitscanSubsystem>())
+	{
+		for (const uint32 RequestId : PendingRequestIds)
+		{
+			Hitscan->CancelShot(RequestId);
+		}
+	}
+
+	PendingRequestIds.Reset();
+
+	Super::OnDestroy(bInOwnerFinished);
+}
+
+void UAbilityTask_WaitHitscanTrace::OnTraceCompleted(uint32 InRequestId, const FHitscanRequest& Request, const FHitResult& HitResult)
+{
+	PendingRequestIds.Remove(InRequestId);
+
+	if (UGA_InventoryCombatAbility* CombatAbility = Cast<UGA_InventoryCombatAbility>(Ability))
+	{
+		bAnyPelletHit |= HitResult.bBlockingHit;
+		ShotTargetData.Add(CombatAbility->MakeWeaponHitTargetData(Request, HitResult));
+	}
+
+	if (PendingRequestIds.Num() == 0)
+	{
+		BroadcastShot();
+	}
+}
+
+void UAbilityTask_WaitHitscanTrace::BroadcastShot()
+{
+	if (ShouldBroadcastAbilityTaskDelegates())
+	{
+		if (bAnyPelletHit)
+		{
+			OnHit.Broadcast(ShotTargetData);
+		}
+		else
+		{
+			OnMiss.Broadcast(ShotTargetData);
+		}
+	}
+
+	EndTask();
+}
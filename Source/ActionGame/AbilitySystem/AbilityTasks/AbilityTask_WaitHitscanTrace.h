@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Abilities/Tasks/AbilityTask.h"
+#include "Abilities/GameplayAbilityTargetTypes.h"
+#include "Engine/EngineTypes.h"
+#include "AbilityTask_WaitHitscanTrace.generated.h"
+
+struct FHitscanRequest;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FWaitHitscanTraceDelegate, const FGameplayAbilityTargetDataHandle&, TargetData);
+
+/**
+ * Fires every pellet of one shot of the equipped weapon through the frame batched hitscan subsystem and waits for them.
+ * Shots traced immediately resolve inside Activate instead, so their result can still join an open ability RPC batch.
+ * The pellets are reported together as weapon hit target data, OnHit when any of them hit something.
+ */
+UCLASS()
+class ACTIONGAME_API UAbilityTask_WaitHitscanTrace : public UAbilityTask
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintAssignable)
+	FWaitHitscanTraceDelegate OnHit;
+
+	UPROPERTY(BlueprintAssignable)
+	FWaitHitscanTraceDelegate OnMiss;
+
+	UFUNCTION(BlueprintCallable, Category = "Ability|Tasks", meta = (HidePin = "OwningAbility", DefaultToSelf = "OwningAbility", BlueprintInternalUseOnly = "TRUE"))
+	static UAbilityTask_WaitHitscanTrace* WaitHitscanTrace(UGameplayAbility* OwningAbility, float TraceDistance, ETraceTypeQuery TraceType, int32 ShotIndex = 0, bool bTraceImmediately = false);
+
+	virtual void Activate() override;
+
+protected:
+	virtual void OnDestroy(bool bInOwnerFinished) override;
+
+	void OnTraceCompleted(uint32 InRequestId, const FHitscanRequest& Request, const FHitResult& HitResult);
+
+	void BroadcastShot();
+
+	float TraceDistance = 0.f;
+
+	TEnumAsByte<ETraceTypeQuery> TraceType;
+
+	int32 ShotIndex = 0;
+
+	bool bTraceImmediately = false;
+
+	TArray<uint32, TInlineAllocator<8>> PendingRequestIds;
+
+	FGameplayAbilityTargetDataHandle ShotTargetData;
+
+	bool bAnyPelletHit = false;
+};
@@ -2,4 +2,67 @@
 
 
 #include "AG_AbilitySystemComponentBase.h"
+#include "ActionGame.h"
+#include "AbilitySystem/Abilities/GA_InventoryCombatAbility.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Batched Ability Activations"), STAT_BatchedAbilityActivations, STATGROUP_ActionGame);
+
+bool UAG_AbilitySystemComponentBase::BatchRPCTryActivateAbility(FGameplayAbilitySpecHandle AbilityHandle)
+{
+	if (!AbilityHandle.IsValid()) return false;
+
+	FScopedServerAbilityRPCBatcher AbilityRPCBatcher(this, AbilityHandle);
+
+	const bool bActivated = TryActivateAbility(AbilityHandle, true);
+
+	INC_DWORD_STAT(STAT_BatchedAbilityActivations);
+
+	return bActivated;
+}
+
+void UAG_AbilitySystemComponentBase::SendInputGameplayEvent(FGameplayTag EventTag)
+{
+	// The server and listen server hosts activate without RPCs, there is nothing to batch
+	if (AbilityActorInfo.IsValid() && AbilityActorInfo->IsLocallyControlled() && !IsOwnerActorAuthoritative())
+	{
+		BatchRPCTryActivateAbilitiesByEvent(EventTag);
+	}
+
+	FGameplayEventData EventPayload;
+	EventPayload.EventTag = EventTag;
+
+	{
+		// Same prediction window UAbilitySystemBlueprintLibrary::SendGameplayEventToActor opens, so triggered abilities can predict
+		FScopedPredictionWindow NewScopedWindow(this, true);
+
+		HandleGameplayEvent(EventTag, &EventPayload);
+	}
+
+	EventBatchedAbilityClasses.Reset();
+}
+
+void UAG_AbilitySystemComponentBase::BatchRPCTryActivateAbilitiesByEvent(FGameplayTag EventTag)
+{
+	TArray<FGameplayAbilitySpecHandle, TInlineAllocator<4>> HandlesToActivate;
+
+	for (const FGameplayAbilitySpec& AbilitySpec : GetActivatableAbilities())
+	{
+		const UGA_InventoryCombatAbility* CombatAbility = Cast<UGA_InventoryCombatAbility>(AbilitySpec.Ability);
+
+		if (CombatAbility && CombatAbility->UsesClientTargetData() && CombatAbility->IsTriggeredByEvent(EventTag))
+		{
+			HandlesToActivate.Add(AbilitySpec.Handle);
+		}
+	}
+
+	for (const FGameplayAbilitySpecHandle& AbilityHandle : HandlesToActivate)
+	{
+		if (BatchRPCTryActivateAbility(AbilityHandle))
+		{
+			if (const FGameplayAbilitySpec* AbilitySpec = FindAbilitySpecFromHandle(AbilityHandle))
+			{
+				EventBatchedAbilityClasses.AddUnique(AbilitySpec->Ability->GetClass());
+			}
+		}
+	}
+}
@@ -13,5 +13,28 @@ UCLASS()
 class ACTIONGAME_API UAG_AbilitySystemComponentBase : public UAbilitySystemComponent
 {
 	GENERATED_BODY()
-	
+
+public:
+	virtual bool ShouldDoServerAbilityRPCBatch() const override { return true; }
+
+	/** Activates the ability with its activate, target data and end RPCs sent to the server as one batch */
+	bool BatchRPCTryActivateAbility(FGameplayAbilitySpecHandle AbilityHandle);
+
+	/**
+	 * Sends an event raised by local input.
+	 * On a predicting client the combat abilities it triggers that opted into client target data are batch activated first, event triggered activations carry event data, which the engine always sends unbatched.
+	 * The event then reaches every listener and every other ability it triggers as usual.
+	 */
+	void SendInputGameplayEvent(FGameplayTag EventTag);
+
+	/** True while an input event is being handled that already batch activated the ability */
+	bool WasBatchActivatedByEvent(const UClass* AbilityClass) const { return EventBatchedAbilityClasses.Contains(AbilityClass); }
+
+	/** True while the ability's RPCs are being collected into a batch */
+	bool IsBatchingAbilityRPCs(FGameplayAbilitySpecHandle AbilityHandle) const { return LocalServerAbilityRPCBatchData.Contains(AbilityHandle); }
+
+protected:
+	void BatchRPCTryActivateAbilitiesByEvent(FGameplayTag EventTag);
+
+	TArray<const UClass*, TInlineAllocator<4>> EventBatchedAbilityClasses;
 };
@@ -12,6 +12,6 @@ public class ActionGame : ModuleRules
 
 		PublicIncludePaths.Add("ActionGame/");
 
-		PrivateDependencyModuleNames.AddRange(new string[] { "GameplayAbilities", "GameplayTags", "GameplayTasks"});
+		PrivateDependencyModuleNames.AddRange(new string[] { "GameplayAbilities", "GameplayTags", "GameplayTasks", "AssetRegistry"});
 	}
 }
@@ -2,6 +2,19 @@
 
 #include "ActionGame.h"
 #include "Modules/ModuleManager.h"
+#include "ActionGameGameplayTags.h"
+#include "ActionGameStatics.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ActionGame, "ActionGame" );
- 
\ No newline at end of file
+DEFINE_LOG_CATEGORY(LogActionGame);
+
+class FActionGameModule : public FDefaultGameModuleImpl
+{
+	virtual void StartupModule() override
+	{
+		FActionGameGameplayTags::InitializeNativeTags();
+
+		UActionGameStatics::InitializeSpreadTable();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FActionGameModule, ActionGame, "ActionGame" );
@@ -3,3 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogActionGame, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("ActionGame"), STATGROUP_ActionGame, STATCAT_Advanced);
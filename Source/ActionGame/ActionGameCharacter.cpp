@@ -23,6 +23,9 @@
 #include "ActorComponents/FootstepsComponent.h"
 #include "ActorComponents/InventoryComponent.h"
 #include "AbilitySystemLog.h"
+#include "ActionGameGameplayTags.h"
+#include "Subsystems/LagCompensationSubsystem.h"
+#include "Subsystems/PlayerSnapshotSubsystem.h"
 #include "GameplayEffectExtension.h"
 
 
@@ -83,8 +86,6 @@ AActionGameCharacter::AActionGameCharacter(const FObjectInitializer& ObjectIniti
 
 	AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(AttributeSet->GetStaminaAttribute()).AddUObject(this, &AActionGameCharacter::OnStaminaAttributeChanged);
 
-	AbilitySystemComponent->RegisterGameplayTagEvent(FGameplayTag::RequestGameplayTag(TEXT("State.Ragdoll")), EGameplayTagEventType::NewOrRemoved).AddUObject(this, &AActionGameCharacter::OnRagdollStateTagChanged);
-
 	AttributeSet = CreateDefaultSubobject<UAG_AttributeSetBase>(TEXT("AttributeSet"));
 
 	FootstepsComponent = CreateDefaultSubobject<UFootstepsComponent>(TEXT("FootstepsComponent"));
@@ -92,6 +93,9 @@ AActionGameCharacter::AActionGameCharacter(const FObjectInitializer& ObjectIniti
 	AGMotionWarpingComponent = CreateDefaultSubobject<UAG_MotionWarpingComponent>(TEXT("MotionWarpingComponent"));
 	InventoryComponent = CreateDefaultSubobject<UInventoryComponent>(TEXT("InventoryComponent"));
 	InventoryComponent->SetIsReplicated(true);
+
+	// Item instances register with the inventory and item actors instead of being walked every net update
+	bReplicateUsingRegisteredSubObjectList = true;
 }
 
 void AActionGameCharacter::PostLoad()
@@ -104,11 +108,27 @@ void AActionGameCharacter::PostLoad()
 	}
 }
 
+void AActionGameCharacter::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Registered here rather than in the constructor, the class default object is built before native tags exist
+	AbilitySystemComponent->RegisterGameplayTagEvent(FActionGameGameplayTags::Get().StateRagdollTag, EGameplayTagEventType::NewOrRemoved).AddUObject(this, &AActionGameCharacter::OnRagdollStateTagChanged);
+}
+
 void AActionGameCharacter::BeginPlay()
 {
 	// Call the base class  
 	Super::BeginPlay();
 
+	if (HasAuthority())
+	{
+		if (ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>())
+		{
+			LagCompensation->RegisterCharacter(this);
+		}
+	}
+
 	//Add Input Mapping Context
 	if (APlayerController* PlayerController = Cast<APlayerController>(Controller))
 	{
@@ -409,33 +429,34 @@ void AActionGameCharacter::OnSprintActionStopped(const FInputActionValue& Value)
 void AActionGameCharacter::OnDropItemTriggered(const FInputActionValue& Value)
 {
 	FGameplayEventData EventPayload;
-	EventPayload.EventTag = UInventoryComponent::DropItemTag;
+	EventPayload.EventTag = FActionGameGameplayTags::Get().DropItemTag;
 	
-	UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(this, UInventoryComponent::DropItemTag, EventPayload);
+	UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(this, FActionGameGameplayTags::Get().DropItemTag, EventPayload);
 }
 
 void AActionGameCharacter::OnEquipNextTriggered(const FInputActionValue& Value)
 {
 	FGameplayEventData EventPayload;
-	EventPayload.EventTag = UInventoryComponent::EquipNextTag;
+	EventPayload.EventTag = FActionGameGameplayTags::Get().EquipNextTag;
 
-	UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(this, UInventoryComponent::EquipNextTag, EventPayload);
+	UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(this, FActionGameGameplayTags::Get().EquipNextTag, EventPayload);
 }
 
 void AActionGameCharacter::OnUnequipTriggered(const FInputActionValue& Value)
 {
 	FGameplayEventData EventPayload;
-	EventPayload.EventTag = UInventoryComponent::UnequipTag;
+	EventPayload.EventTag = FActionGameGameplayTags::Get().UnequipTag;
 
-	UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(this, UInventoryComponent::UnequipTag, EventPayload);
+	UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(this, FActionGameGameplayTags::Get().UnequipTag, EventPayload);
 }
 
 void AActionGameCharacter::OnAttackActionStarted(const FInputActionValue& Value)
 {
-	FGameplayEventData EventPayload;
-	EventPayload.EventTag = AttackStartedEventTag;
-
-	UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(this, AttackStartedEventTag, EventPayload);
+	// Abilities that send their own hits as target data activate in a single batched RPC, everything else still receives the event
+	if (AbilitySystemComponent)
+	{
+		AbilitySystemComponent->SendInputGameplayEvent(AttackStartedEventTag);
+	}
 }
 
 void AActionGameCharacter::OnAttackActionStopped(const FInputActionValue& Value)
@@ -538,6 +559,44 @@ void AActionGameCharacter::PossessedBy(AController* NewController)
 
 	GiveAbilities();
 	ApplyStartupEffects();
+
+	if (UPlayerSnapshotSubsystem* PlayerSnapshots = GetGameInstance()->GetSubsystem<UPlayerSnapshotSubsystem>())
+	{
+		PlayerSnapshots->RestorePlayer(this);
+	}
+}
+
+void AActionGameCharacter::UnPossessed()
+{
+	// Saved while the player state is still set, unpossessing clears it
+	if (UPlayerSnapshotSubsystem* PlayerSnapshots = GetGameInstance()->GetSubsystem<UPlayerSnapshotSubsystem>())
+	{
+		// Dying resets the loadout, the respawned character starts from its defaults
+		if (AbilitySystemComponent->HasMatchingGameplayTag(FActionGameGameplayTags::Get().StateDeadTag))
+		{
+			PlayerSnapshots->ForgetPlayer(this);
+		}
+		else
+		{
+			PlayerSnapshots->SavePlayer(this);
+		}
+	}
+
+	Super::UnPossessed();
+}
+
+void AActionGameCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Map changes and shutdown tear characters down without unpossessing them
+	if (GetPlayerState())
+	{
+		if (UPlayerSnapshotSubsystem* PlayerSnapshots = GetGameInstance()->GetSubsystem<UPlayerSnapshotSubsystem>())
+		{
+			PlayerSnapshots->SavePlayer(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Client 
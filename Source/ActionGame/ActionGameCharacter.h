@@ -37,6 +37,7 @@ public:
 	AActionGameCharacter(const FObjectInitializer& ObjectInitializer);
 
 	virtual void PostLoad() override;
+	virtual void PostInitializeComponents() override;
 
 	bool ApplyGameplayEffectToSelf(TSubclassOf<UGameplayEffect> Effect, FGameplayEffectContextHandle InEffectContext);
 
@@ -55,6 +56,8 @@ protected:
 	void ApplyStartupEffects();
 
 	virtual void PossessedBy(AController* NewController) override;
+	virtual void UnPossessed() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void OnRep_PlayerState() override;
 
 	UPROPERTY(EditDefaultsOnly)
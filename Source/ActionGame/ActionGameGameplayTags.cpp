@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActionGameGameplayTags.h"
+#include "GameplayTagsManager.h"
+
+FActionGameGameplayTags FActionGameGameplayTags::GameplayTags;
+
+void FActionGameGameplayTags::InitializeNativeTags()
+{
+	GameplayTags.TagNames.Reset();
+
+	GameplayTags.AddTag(GameplayTags.AttributeHealthTag, "Attribute.Health", "Health set by caller magnitude");
+
+	GameplayTags.AddTag(GameplayTags.StateDeadTag, "State.Dead", "Owner is dead");
+	GameplayTags.AddTag(GameplayTags.StateRagdollTag, "State.Ragdoll", "Owner is ragdolling");
+
+	GameplayTags.AddTag(GameplayTags.MovementEnforcedStrafeTag, "Movement.Enforced.Strafe", "Force strafe movement");
+
+	GameplayTags.AddTag(GameplayTags.EquipItemActorTag, "Event.Inventory.EquipItemActor", "Equip item from item actor event");
+	GameplayTags.AddTag(GameplayTags.DropItemTag, "Event.Inventory.DropItem", "Drop equipped item");
+	GameplayTags.AddTag(GameplayTags.EquipNextTag, "Event.Inventory.EquipNext", "Try equip next item");
+	GameplayTags.AddTag(GameplayTags.UnequipTag, "Event.Inventory.Unequip", "Unequip current item");
+}
+
+void FActionGameGameplayTags::AddTag(FGameplayTag& OutTag, const ANSICHAR* TagName, const ANSICHAR* TagComment)
+{
+	OutTag = UGameplayTagsManager::Get().AddNativeGameplayTag(FName(TagName), FString(TagComment));
+
+	TagNames.Add(OutTag.GetTagName());
+}
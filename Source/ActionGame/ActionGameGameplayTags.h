@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+ * Native gameplay tags used from C++, resolved once when the module starts up.
+ */
+struct ACTIONGAME_API FActionGameGameplayTags
+{
+public:
+	static const FActionGameGameplayTags& Get() { return GameplayTags; }
+
+	static void InitializeNativeTags();
+
+	/** Names of every tag added by InitializeNativeTags */
+	const TArray<FName>& GetTagNames() const { return TagNames; }
+
+	FGameplayTag AttributeHealthTag;
+
+	FGameplayTag StateDeadTag;
+	FGameplayTag StateRagdollTag;
+
+	FGameplayTag MovementEnforcedStrafeTag;
+
+	FGameplayTag EquipItemActorTag;
+	FGameplayTag DropItemTag;
+	FGameplayTag EquipNextTag;
+	FGameplayTag UnequipTag;
+
+protected:
+	void AddTag(FGameplayTag& OutTag, const ANSICHAR* TagName, const ANSICHAR* TagComment);
+
+	TArray<FName> TagNames;
+
+private:
+	static FActionGameGameplayTags GameplayTags;
+};
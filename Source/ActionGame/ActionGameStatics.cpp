@@ -3,10 +3,20 @@
 
 #include "ActionGameStatics.h"
 
+#include "ActionGame.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "AbilitySystemComponent.h"
 #include "Actors/Projectile.h"
 #include "AbilitySystemBlueprintLibrary.h"
+#include "ActionGameGameplayTags.h"
+#include "Subsystems/ProjectilePoolSubsystem.h"
+#include "Subsystems/ProjectileSimulationSubsystem.h"
+#include "Subsystems/RadialDamageSubsystem.h"
+#include "GameplayPrediction.h"
+#include "Engine/AssetManager.h"
+#include "Animation/AnimMontage.h"
+
+DECLARE_CYCLE_STAT(TEXT("Ballistic Solve"), STAT_BallisticSolve, STATGROUP_ActionGame);
 
 static TAutoConsoleVariable<int32> CVarShowRadialDamage(
 	TEXT("ShowDebugRadialDamage"),
@@ -17,6 +27,12 @@ static TAutoConsoleVariable<int32> CVarShowRadialDamage(
 	ECVF_Cheat
 );
 
+// Power of two so seeds wrap with a mask, large enough that pellets of nearby seeds do not repeat
+static const int32 SpreadTableSize = 1024;
+
+// Uniform points in the unit disc
+static TArray<FVector2f> SpreadTable;
+
 const UItemStaticData* UActionGameStatics::GetItemStaticData(TSubclassOf<UItemStaticData> ItemDataClass)
 {
 	if (IsValid(ItemDataClass))
@@ -27,64 +43,100 @@ const UItemStaticData* UActionGameStatics::GetItemStaticData(TSubclassOf<UItemSt
 	return nullptr;
 }
 
+TSharedPtr<FStreamableHandle> UActionGameStatics::RequestStaticDataAssets(TSubclassOf<UObject> StaticDataClass)
+{
+	if (!IsValid(StaticDataClass)) return nullptr;
+
+	const UObject* StaticData = StaticDataClass->GetDefaultObject();
+
+	TArray<FSoftObjectPath> AssetPaths;
+
+	for (TFieldIterator<FSoftObjectProperty> PropertyIt(StaticDataClass); PropertyIt; ++PropertyIt)
+	{
+		const FSoftObjectPtr* SoftObject = PropertyIt->GetPropertyValuePtr_InContainer(StaticData);
+
+		if (SoftObject && !SoftObject->IsNull())
+		{
+			AssetPaths.Add(SoftObject->ToSoftObjectPath());
+		}
+	}
+
+	if (AssetPaths.Num() == 0) return nullptr;
+
+	return UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(AssetPaths));
+}
+
 void UActionGameStatics::ApplyRadialDamage(UObject* WorldContextObject, AActor* DamageCauser, FVector Location, float Radius, float DamageAmount, TArray<TSubclassOf<UGameplayEffect>> DamageEffects, const TArray<TEnumAsByte<EObjectTypeQuery>>& ObjectTypes, ETraceTypeQuery TraceType)
 {
-	TArray<AActor*> OutActors;
-	TArray<AActor*> ActorsToIgnore = { DamageCauser };
+	URadialDamageSubsystem* RadialDamage = WorldContextObject ? WorldContextObject->GetWorld()->GetSubsystem<URadialDamageSubsystem>() : nullptr;
+
+	if (RadialDamage && URadialDamageSubsystem::IsAsyncEnabled())
+	{
+		RadialDamage->QueueRadialDamage(WorldContextObject, DamageCauser, Location, Radius, DamageAmount, DamageEffects, ObjectTypes, TraceType);
+	}
+	else
+	{
+		TArray<AActor*> OutActors;
+		TArray<AActor*> ActorsToIgnore = { DamageCauser };
+
+		UKismetSystemLibrary::SphereOverlapActors(WorldContextObject, Location, Radius, ObjectTypes, nullptr, ActorsToIgnore, OutActors);
 
-	UKismetSystemLibrary::SphereOverlapActors(WorldContextObject, Location, Radius, ObjectTypes, nullptr, ActorsToIgnore, OutActors);
+		for (AActor* Actor : OutActors)
+		{
+			FHitResult HitResult;
+
+			const bool bHit = UKismetSystemLibrary::LineTraceSingle(WorldContextObject, Location, Actor->GetActorLocation(), TraceType, true, ActorsToIgnore, EDrawDebugTrace::None, HitResult, true);
 
+			ApplyRadialDamageToActor(WorldContextObject, DamageCauser, Location, Actor, HitResult, bHit, DamageAmount, DamageEffects);
+		}
+	}
+
+	if (static_cast<bool>(CVarShowRadialDamage.GetValueOnAnyThread()))
+	{
+		DrawDebugSphere(WorldContextObject->GetWorld(), Location, Radius, 16, FColor::Red, false, 4.f, 0, 1);
+	}
+}
+
+void UActionGameStatics::ApplyRadialDamageToActor(UObject* WorldContextObject, AActor* DamageCauser, const FVector& Location, AActor* Actor, const FHitResult& HitResult, bool bHit, float DamageAmount, const TArray<TSubclassOf<UGameplayEffect>>& DamageEffects)
+{
 	const bool bDebug = static_cast<bool>(CVarShowRadialDamage.GetValueOnAnyThread());
 
-	for (AActor* Actor : OutActors)
+	if (bHit)
 	{
-		FHitResult HitResult;
-		
-		if (UKismetSystemLibrary::LineTraceSingle(WorldContextObject, Location, Actor->GetActorLocation(), TraceType, true, ActorsToIgnore, EDrawDebugTrace::None, HitResult, true))
+		AActor* Target = HitResult.GetActor();
+
+		if (Target == Actor)
 		{
-			AActor* Target = HitResult.GetActor();
+			bool bWasApplied = false;
+			bool bWasQueued = false;
 
-			if (Target == Actor)
+			if (UAbilitySystemComponent* AbilityComponenet = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Target))
 			{
-				bool bWasApplied = false;
+				URadialDamageSubsystem* RadialDamage = WorldContextObject->GetWorld()->GetSubsystem<URadialDamageSubsystem>();
 
-				if (UAbilitySystemComponent* AbilityComponenet = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Target))
+				for (auto Effect : DamageEffects)
 				{
-					FGameplayEffectContextHandle EffectContext = AbilityComponenet->MakeEffectContext();
-					EffectContext.AddInstigator(DamageCauser, DamageCauser);
+					if (RadialDamage && URadialDamageSubsystem::CanCoalesce(Effect))
+					{
+						// Summed with every other hit on this target this frame and applied as one spec when the subsystem flushes
+						RadialDamage->AccumulateDamage(AbilityComponenet, Effect, DamageCauser, DamageAmount);
 
-					for (auto Effect : DamageEffects)
+						bWasQueued = true;
+					}
+					else if (ApplyDamageEffect(AbilityComponenet, Effect, DamageCauser, DamageAmount))
 					{
-						FGameplayEffectSpecHandle SpecHandle = AbilityComponenet->MakeOutgoingSpec(Effect, 1, EffectContext);
-						if (SpecHandle.IsValid())
-						{
-							UAbilitySystemBlueprintLibrary::AssignTagSetByCallerMagnitude(SpecHandle, FGameplayTag::RequestGameplayTag(TEXT("Attribute.Health")), -DamageAmount);
-
-							FActiveGameplayEffectHandle ActiveGEHandle = AbilityComponenet->ApplyGameplayEffectSpecToSelf(*SpecHandle.Data.Get());
-
-							if (ActiveGEHandle.WasSuccessfullyApplied())
-							{
-								bWasApplied = true;
-							}
-						}
+						bWasApplied = true;
 					}
 				}
-
-				if (bDebug)
-				{
-					DrawDebugLine(WorldContextObject->GetWorld(), Location, Actor->GetActorLocation(), bWasApplied ? FColor::Green : FColor::Red, false, 4.f, 0, 1);
-					DrawDebugSphere(WorldContextObject->GetWorld(), HitResult.Location, 16, 16, bWasApplied ? FColor::Green : FColor::Red, false, 4.f, 0, 1);
-					DrawDebugString(WorldContextObject->GetWorld(), HitResult.Location, *GetNameSafe(Target), nullptr, FColor::White, 0, false, 1.f);
-				}
 			}
-			else
+
+			if (bDebug)
 			{
-				if (bDebug)
-				{
-					DrawDebugLine(WorldContextObject->GetWorld(), Location, Actor->GetActorLocation(), FColor::Red, false, 4.f, 0, 1);
-					DrawDebugSphere(WorldContextObject->GetWorld(), HitResult.Location, 16, 16, FColor::Red, false, 4.f, 0, 1);
-					DrawDebugString(WorldContextObject->GetWorld(), HitResult.Location, *GetNameSafe(Target), nullptr, FColor::Red, 0, false, 1.f);
-				}
+				const FColor DebugColor = bWasApplied ? FColor::Green : bWasQueued ? FColor::Yellow : FColor::Red;
+
+				DrawDebugLine(WorldContextObject->GetWorld(), Location, Actor->GetActorLocation(), DebugColor, false, 4.f, 0, 1);
+				DrawDebugSphere(WorldContextObject->GetWorld(), HitResult.Location, 16, 16, DebugColor, false, 4.f, 0, 1);
+				DrawDebugString(WorldContextObject->GetWorld(), HitResult.Location, *GetNameSafe(Target), nullptr, FColor::White, 0, false, 1.f);
 			}
 		}
 		else
@@ -93,15 +145,37 @@ void UActionGameStatics::ApplyRadialDamage(UObject* WorldContextObject, AActor*
 			{
 				DrawDebugLine(WorldContextObject->GetWorld(), Location, Actor->GetActorLocation(), FColor::Red, false, 4.f, 0, 1);
 				DrawDebugSphere(WorldContextObject->GetWorld(), HitResult.Location, 16, 16, FColor::Red, false, 4.f, 0, 1);
-				DrawDebugString(WorldContextObject->GetWorld(), HitResult.Location, *GetNameSafe(HitResult.GetActor()), nullptr, FColor::Red, 0, false, 1.f);
+				DrawDebugString(WorldContextObject->GetWorld(), HitResult.Location, *GetNameSafe(Target), nullptr, FColor::Red, 0, false, 1.f);
 			}
 		}
 	}
+	else
+	{
+		if (bDebug)
+		{
+			DrawDebugLine(WorldContextObject->GetWorld(), Location, Actor->GetActorLocation(), FColor::Red, false, 4.f, 0, 1);
+			DrawDebugSphere(WorldContextObject->GetWorld(), HitResult.Location, 16, 16, FColor::Red, false, 4.f, 0, 1);
+			DrawDebugString(WorldContextObject->GetWorld(), HitResult.Location, *GetNameSafe(HitResult.GetActor()), nullptr, FColor::Red, 0, false, 1.f);
+		}
+	}
+}
+
+bool UActionGameStatics::ApplyDamageEffect(UAbilitySystemComponent* TargetComponent, TSubclassOf<UGameplayEffect> DamageEffect, AActor* DamageCauser, float DamageAmount)
+{
+	FGameplayEffectContextHandle EffectContext = TargetComponent->MakeEffectContext();
+	EffectContext.AddInstigator(DamageCauser, DamageCauser);
 
-	if (bDebug)
+	FGameplayEffectSpecHandle SpecHandle = TargetComponent->MakeOutgoingSpec(DamageEffect, 1, EffectContext);
+	if (SpecHandle.IsValid())
 	{
-		DrawDebugSphere(WorldContextObject->GetWorld(), Location, Radius, 16, FColor::Red, false, 4.f, 0, 1);
+		UAbilitySystemBlueprintLibrary::AssignTagSetByCallerMagnitude(SpecHandle, FActionGameGameplayTags::Get().AttributeHealthTag, -DamageAmount);
+
+		FActiveGameplayEffectHandle ActiveGEHandle = TargetComponent->ApplyGameplayEffectSpecToSelf(*SpecHandle.Data.Get());
+
+		return ActiveGEHandle.WasSuccessfullyApplied();
 	}
+
+	return false;
 }
 
 AProjectile* UActionGameStatics::LaunchProjectile(UObject* WorldContextObject, TSubclassOf<UProjectileStaticData> ProjectileDataClass, FTransform Transform, AActor* Owner, APawn* Instigator)
@@ -110,6 +184,23 @@ AProjectile* UActionGameStatics::LaunchProjectile(UObject* WorldContextObject, T
 
 	if (World && World->IsServer())
 	{
+		const UProjectileStaticData* ProjectileData = IsValid(ProjectileDataClass) ? GetDefault<UProjectileStaticData>(ProjectileDataClass) : nullptr;
+
+		if (ProjectileData && (ProjectileData->SimulationMode == EProjectileSimulationMode::Batched || ProjectileData->SimulationMode == EProjectileSimulationMode::Virtual))
+		{
+			if (UProjectileSimulationSubsystem* ProjectileSimulation = World->GetSubsystem<UProjectileSimulationSubsystem>())
+			{
+				ProjectileSimulation->LaunchProjectile(ProjectileDataClass, Transform, Owner, Instigator);
+
+				return nullptr;
+			}
+		}
+
+		if (UProjectilePoolSubsystem* ProjectilePool = World->GetSubsystem<UProjectilePoolSubsystem>())
+		{
+			return ProjectilePool->AcquireProjectile(ProjectileDataClass, Transform, Owner, Instigator);
+		}
+
 		if (AProjectile* Projectile = World->SpawnActorDeferred<AProjectile>(AProjectile::StaticClass(), Transform, Owner, Instigator, ESpawnActorCollisionHandlingMethod::AlwaysSpawn))
 		{
 			Projectile->ProjectileDataClass = ProjectileDataClass;
@@ -121,3 +212,269 @@ AProjectile* UActionGameStatics::LaunchProjectile(UObject* WorldContextObject, T
 
 	return nullptr;
 }
+
+/** Largest real root of x^3 + A x^2 + B x + C, by Cardano's formula or its trigonometric form when all three roots are real */
+static double SolveCubicLargestRoot(double A, double B, double C)
+{
+	const double P = B - A * A / 3.0;
+	const double Q = 2.0 * A * A * A / 27.0 - A * B / 3.0 + C;
+	const double Discriminant = Q * Q / 4.0 + P * P * P / 27.0;
+
+	double Z = 0.0;
+
+	if (Discriminant >= 0.0)
+	{
+		const double SqrtDiscriminant = FMath::Sqrt(Discriminant);
+		const double U = -Q / 2.0 + SqrtDiscriminant;
+		const double V = -Q / 2.0 - SqrtDiscriminant;
+
+		Z = FMath::Sign(U) * FMath::Pow(FMath::Abs(U), 1.0 / 3.0) + FMath::Sign(V) * FMath::Pow(FMath::Abs(V), 1.0 / 3.0);
+	}
+	else
+	{
+		// P is negative whenever the discriminant is
+		const double Radius = 2.0 * FMath::Sqrt(-P / 3.0);
+
+		Z = Radius * FMath::Cos(FMath::Acos(FMath::Clamp(3.0 * Q / (P * Radius), -1.0, 1.0)) / 3.0);
+	}
+
+	return Z - A / 3.0;
+}
+
+/** Keeps the smallest positive time among InOutTime and the real roots of y^2 + B y + C, with time = y + Shift */
+static void KeepSmallestPositiveRoot(double B, double C, double Shift, double& InOutTime)
+{
+	const double Discriminant = B * B - 4.0 * C;
+
+	if (Discriminant < 0.0) return;
+
+	const double SqrtDiscriminant = FMath::Sqrt(Discriminant);
+
+	for (const double Root : { (-B - SqrtDiscriminant) * 0.5, (-B + SqrtDiscriminant) * 0.5 })
+	{
+		const double Time = Root + Shift;
+
+		if (Time > KINDA_SMALL_NUMBER && Time < InOutTime)
+		{
+			InOutTime = Time;
+		}
+	}
+}
+
+/** Smallest positive real root of C4 t^4 + C3 t^3 + C2 t^2 + C1 t + C0, in closed form by Ferrari's method */
+static bool SolveQuarticSmallestPositiveRoot(double C4, double C3, double C2, double C1, double C0, double& OutTime)
+{
+	const double NoRoot = TNumericLimits<double>::Max();
+
+	OutTime = NoRoot;
+
+	// Without gravity the cubic term goes as well, leaving a quadratic
+	if (FMath::Abs(C4) <= KINDA_SMALL_NUMBER)
+	{
+		if (FMath::Abs(C2) > KINDA_SMALL_NUMBER)
+		{
+			KeepSmallestPositiveRoot(C1 / C2, C0 / C2, 0.0, OutTime);
+		}
+		else if (FMath::Abs(C1) > KINDA_SMALL_NUMBER && -C0 / C1 > KINDA_SMALL_NUMBER)
+		{
+			OutTime = -C0 / C1;
+		}
+		return OutTime < NoRoot;
+	}
+
+	// Depressed quartic y^4 + P y^2 + Q y + R with t = y - A / 4
+	const double A = C3 / C4;
+	const double B = C2 / C4;
+	const double C = C1 / C4;
+	const double D = C0 / C4;
+
+	const double A2 = A * A;
+	const double P = B - 3.0 * A2 / 8.0;
+	const double Q = C - A * B / 2.0 + A2 * A / 8.0;
+	const double R = D - A * C / 4.0 + A2 * B / 16.0 - 3.0 * A2 * A2 / 256.0;
+	const double Shift = -A / 4.0;
+
+	if (FMath::Abs(Q) <= KINDA_SMALL_NUMBER)
+	{
+		// Biquadratic, as for a stationary target, solved as a quadratic in y^2
+		const double Discriminant = P * P - 4.0 * R;
+
+		if (Discriminant < 0.0) return false;
+
+		const double SqrtDiscriminant = FMath::Sqrt(Discriminant);
+
+		for (const double RootSquared : { (-P - SqrtDiscriminant) * 0.5, (-P + SqrtDiscriminant) * 0.5 })
+		{
+			if (RootSquared >= 0.0)
+			{
+				KeepSmallestPositiveRoot(0.0, -RootSquared, Shift, OutTime);
+			}
+		}
+		return OutTime < NoRoot;
+	}
+
+	// A positive root M of the resolvent cubic splits the quartic into (y^2 + P / 2 + M)^2 = 2M (y - Q / 4M)^2, two quadratics
+	const double M = SolveCubicLargestRoot(P, P * P / 4.0 - R, -Q * Q / 8.0);
+
+	if (M <= 0.0) return false;
+
+	const double S = FMath::Sqrt(2.0 * M);
+
+	KeepSmallestPositiveRoot(-S, P / 2.0 + M + Q / (2.0 * S), Shift, OutTime);
+	KeepSmallestPositiveRoot(S, P / 2.0 + M - Q / (2.0 * S), Shift, OutTime);
+
+	return OutTime < NoRoot;
+}
+
+static void SolveBallisticQuery(const UWorld* World, const FBallisticQuery& Query, bool bVerifyPath, FBallisticSolution& OutSolution)
+{
+	const UProjectileStaticData* ProjectileData = IsValid(Query.ProjectileDataClass) ? GetDefault<UProjectileStaticData>(Query.ProjectileDataClass) : nullptr;
+
+	if (!ProjectileData || ProjectileData->InitialSpeed <= 0.f) return;
+
+	const FVector Delta = Query.Target - Query.Origin;
+	const FVector& Velocity = Query.TargetVelocity;
+	const double Az = -0.5 * World->GetGravityZ() * ProjectileData->GravityMultiplyer;
+	const double Speed = ProjectileData->InitialSpeed;
+
+	// The launch velocity U satisfies U * t = D + V * t + A * t^2 with A = -g / 2, and |U| = Speed.
+	// Squaring gives a quartic in t, its smallest positive root is the earliest intercept on the low arc.
+	const double C4 = Az * Az;
+	const double C3 = 2.0 * Az * Velocity.Z;
+	const double C2 = Velocity.SizeSquared() + 2.0 * Az * Delta.Z - Speed * Speed;
+	const double C1 = 2.0 * (Delta | Velocity);
+	const double C0 = Delta.SizeSquared();
+
+	double FlightTime = 0.0;
+
+	if (!SolveQuarticSmallestPositiveRoot(C4, C3, C2, C1, C0, FlightTime)) return;
+
+	const FVector LaunchVelocity = (Delta + Velocity * FlightTime + FVector(0.0, 0.0, Az * FlightTime * FlightTime)) / FlightTime;
+
+	// Targets at the very edge of range leave a root the rounding has moved, so check the speed actually matches
+	if (!FMath::IsNearlyEqual(LaunchVelocity.Size(), Speed, Speed * 0.01)) return;
+
+	OutSolution.bHasSolution = true;
+	OutSolution.LaunchVelocity = LaunchVelocity;
+	OutSolution.FlightTime = (float)FlightTime;
+	OutSolution.InterceptLocation = Query.Target + Query.TargetVelocity * FlightTime;
+
+	if (!bVerifyPath) return;
+
+	static const FName BallisticVerifyName = TEXT("BallisticVerify");
+	static const FName ProjectileProfileName = TEXT("Projectile");
+
+	FCollisionQueryParams QueryParams(BallisticVerifyName, false);
+	QueryParams.AddIgnoredActor(Query.TargetActor);
+
+	// Sweep the arc as two chords through the position at half the flight time
+	const double HalfTime = 0.5 * FlightTime;
+	const FVector Midpoint = Query.Origin + LaunchVelocity * HalfTime - FVector(0.0, 0.0, Az * HalfTime * HalfTime);
+	const FCollisionShape Shape = FCollisionShape::MakeSphere(ProjectileData->CollisionRadius);
+
+	OutSolution.bBlocked = World->SweepTestByProfile(Query.Origin, Midpoint, FQuat::Identity, ProjectileProfileName, Shape, QueryParams)
+		|| World->SweepTestByProfile(Midpoint, OutSolution.InterceptLocation, FQuat::Identity, ProjectileProfileName, Shape, QueryParams);
+}
+
+void UActionGameStatics::SolveBallisticLaunches(UObject* WorldContextObject, const TArray<FBallisticQuery>& Queries, TArray<FBallisticSolution>& OutSolutions, bool bVerifyPath)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BallisticSolve);
+
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+
+	const int32 NumQueries = Queries.Num();
+
+	OutSolutions.Reset(NumQueries);
+	OutSolutions.AddDefaulted(NumQueries);
+
+	if (!World) return;
+
+	// Each query is solved in closed form on its own, so a batch needs no scratch memory
+	for (int32 i = 0; i < NumQueries; ++i)
+	{
+		SolveBallisticQuery(World, Queries[i], bVerifyPath, OutSolutions[i]);
+	}
+}
+
+FBallisticSolution UActionGameStatics::SolveBallisticLaunch(UObject* WorldContextObject, const FBallisticQuery& Query, bool bVerifyPath)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BallisticSolve);
+
+	FBallisticSolution Solution;
+
+	if (UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr)
+	{
+		SolveBallisticQuery(World, Query, bVerifyPath, Solution);
+	}
+
+	return Solution;
+}
+
+void UActionGameStatics::InitializeSpreadTable()
+{
+	// A fixed seed, every build generates the same table
+	FRandomStream RandomStream(0x5EED);
+
+	SpreadTable.SetNumUninitialized(SpreadTableSize);
+
+	for (FVector2f& Offset : SpreadTable)
+	{
+		const float Radius = FMath::Sqrt(RandomStream.GetFraction());
+		const float Angle = RandomStream.GetFraction() * UE_TWO_PI;
+
+		Offset = FVector2f(Radius * FMath::Cos(Angle), Radius * FMath::Sin(Angle));
+	}
+}
+
+int32 UActionGameStatics::MakeShotSeed(const FPredictionKey& PredictionKey, int32 ShotIndex)
+{
+	return static_cast<int32>(HashCombine(GetTypeHash(PredictionKey.Current), GetTypeHash(ShotIndex)));
+}
+
+FVector UActionGameStatics::GetWeaponSpreadDirection(const UWeaponStaticData* WeaponData, FVector AimDirection, int32 ShotSeed, int32 PelletIndex)
+{
+	AimDirection.Normalize();
+
+	if (!WeaponData || WeaponData->SpreadAngle <= 0.f || SpreadTable.Num() == 0) return AimDirection;
+
+	// Odd stride so every pellet of a shot lands on a different entry
+	const FVector2f& Offset = SpreadTable[(static_cast<uint32>(ShotSeed) + PelletIndex * 97u) & (SpreadTableSize - 1)];
+
+	FVector Right, Up;
+	AimDirection.FindBestAxisVectors(Right, Up);
+
+	const float ConeRadius = FMath::Tan(FMath::DegreesToRadians(WeaponData->SpreadAngle));
+
+	return (AimDirection + (Right * Offset.X + Up * Offset.Y) * ConeRadius).GetSafeNormal();
+}
+
+void UActionGameStatics::GetWeaponSpreadDirections(const UWeaponStaticData* WeaponData, FVector AimDirection, int32 ShotSeed, TArray<FVector>& OutDirections)
+{
+	const int32 PelletCount = WeaponData ? FMath::Max(WeaponData->PelletCount, 1) : 1;
+
+	OutDirections.Reset(PelletCount);
+
+	for (int32 PelletIndex = 0; PelletIndex < PelletCount; ++PelletIndex)
+	{
+		OutDirections.Add(GetWeaponSpreadDirection(WeaponData, AimDirection, ShotSeed, PelletIndex));
+	}
+}
+
+FRotator UActionGameStatics::GetWeaponRecoil(const UWeaponStaticData* WeaponData, int32 ShotIndex, int32 ShotSeed)
+{
+	if (!WeaponData || WeaponData->RecoilPattern.Num() == 0) return FRotator::ZeroRotator;
+
+	const FVector2D& Kick = WeaponData->RecoilPattern[FMath::Clamp(ShotIndex, 0, WeaponData->RecoilPattern.Num() - 1)];
+
+	// Offset from the spread lookup so jitter is not correlated with the first pellet
+	const FVector2f Jitter = SpreadTable.Num() > 0 ? SpreadTable[(static_cast<uint32>(ShotSeed) + SpreadTableSize / 2) & (SpreadTableSize - 1)] * WeaponData->RecoilJitter : FVector2f::ZeroVector;
+
+	return FRotator(Kick.X + Jitter.X, Kick.Y + Jitter.Y, 0.f);
+}
+
+UAnimMontage* UActionGameStatics::GetWeaponAttackMontage(const UWeaponStaticData* WeaponData)
+{
+	if (!WeaponData) return nullptr;
+
+	return WeaponData->AttackMontage;
+}
@@ -7,6 +7,9 @@
 #include "ActionGameTypes.h"
 #include "ActionGameStatics.generated.h"
 
+struct FPredictionKey;
+struct FStreamableHandle;
+
 /**
  * 
  */
@@ -19,9 +22,45 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	static const UItemStaticData* GetItemStaticData(TSubclassOf<UItemStaticData> ItemDataClass);
 
+	/** Starts async loading every soft referenced asset of a static data class, the assets stay loaded while the handle is held */
+	static TSharedPtr<FStreamableHandle> RequestStaticDataAssets(TSubclassOf<UObject> StaticDataClass);
+
 	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject"))
 	static void ApplyRadialDamage(UObject* WorldContextObject, AActor* DamageCauser, FVector Location, float Radius, float DamageAmount, TArray<TSubclassOf<class UGameplayEffect>> DamageEffects, const TArray<TEnumAsByte<EObjectTypeQuery>>& ObjectTypes, ETraceTypeQuery TraceType);
+
+	/** Applies the damage effects to one overlapped actor if the line of sight trace reached it */
+	static void ApplyRadialDamageToActor(UObject* WorldContextObject, AActor* DamageCauser, const FVector& Location, AActor* Actor, const FHitResult& HitResult, bool bHit, float DamageAmount, const TArray<TSubclassOf<class UGameplayEffect>>& DamageEffects);
+
+	/** Applies one damage effect spec with the damage amount as the health set by caller magnitude */
+	static bool ApplyDamageEffect(class UAbilitySystemComponent* TargetComponent, TSubclassOf<class UGameplayEffect> DamageEffect, AActor* DamageCauser, float DamageAmount);
 	
 	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject"))
 	static AProjectile* LaunchProjectile(UObject* WorldContextObject, TSubclassOf<UProjectileStaticData> ProjectileDataClass, FTransform Transform, AActor* Owner, APawn* Instigator);
+
+	/** Solves low arc launch velocities for a batch of projectiles, leading moving targets */
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject"))
+	static void SolveBallisticLaunches(UObject* WorldContextObject, const TArray<FBallisticQuery>& Queries, TArray<FBallisticSolution>& OutSolutions, bool bVerifyPath = false);
+
+	UFUNCTION(BlueprintCallable, meta = (WorldContext = "WorldContextObject"))
+	static FBallisticSolution SolveBallisticLaunch(UObject* WorldContextObject, const FBallisticQuery& Query, bool bVerifyPath = false);
+
+	/** Builds the shared spread table once at module load, so client and server evaluate shots from identical data */
+	static void InitializeSpreadTable();
+
+	/** Seed for a predicted shot, the same on the predicting client and the server */
+	static int32 MakeShotSeed(const FPredictionKey& PredictionKey, int32 ShotIndex);
+
+	UFUNCTION(BlueprintPure)
+	static FVector GetWeaponSpreadDirection(const UWeaponStaticData* WeaponData, FVector AimDirection, int32 ShotSeed, int32 PelletIndex = 0);
+
+	/** Directions of every pellet of one shot */
+	UFUNCTION(BlueprintPure)
+	static void GetWeaponSpreadDirections(const UWeaponStaticData* WeaponData, FVector AimDirection, int32 ShotSeed, TArray<FVector>& OutDirections);
+
+	/** Recoil kick of one shot of a burst, pattern plus seeded jitter */
+	UFUNCTION(BlueprintPure)
+	static FRotator GetWeaponRecoil(const UWeaponStaticData* WeaponData, int32 ShotIndex, int32 ShotSeed);
+
+	/** The weapon's attack montage, already loaded with its static data so firing never loads it */
+	static class UAnimMontage* GetWeaponAttackMontage(const UWeaponStaticData* WeaponData);
 };
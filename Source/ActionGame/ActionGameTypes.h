@@ -45,7 +45,7 @@ enum class EFoot : uint8
 	Right UMETA(DisplayName = "Right")
 };
 
-UCLASS(BlueprintType, Blueprintable)
+UCLASS(BlueprintType, Blueprintable, Config = Game)
 class UItemStaticData : public UObject 
 {
 	GENERATED_BODY()
@@ -63,6 +63,19 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	bool bCanBeEquipped = false;
 
+	/** Items without per item state, like ammo and consumables, are stored as stacks in the inventory instead of as instances */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	bool bRequiresInstance = true;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta = (ClampMin = 1, ClampMax = 65535, EditCondition = "!bRequiresInstance"))
+	int32 MaxStackSize = 1;
+
+	bool RequiresInstance() const { return bRequiresInstance || bCanBeEquipped; }
+
+	/** Unclaimed items with a world mesh wait in the world as an instanced mesh, and only become an item actor while a player is near */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Config)
+	TSoftObjectPtr<class UStaticMesh> WorldStaticMesh;
+
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	FCharacterAnimationData CharacterAnimationData;
 
@@ -100,14 +113,16 @@ public:
 	TSubclassOf<class UGameplayEffect> DamageEffect;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
-	USkeletalMesh* SkeletalMesh;
+	TSoftObjectPtr<USkeletalMesh> SkeletalMesh;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
-	UStaticMesh* StaticMesh;
+	TSoftObjectPtr<UStaticMesh> StaticMesh;
 
+	/** Read directly by the fire abilities in Blueprint, so it stays a hard reference loaded with the static data */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	UAnimMontage* AttackMontage;
 
+	/** Seconds between shots when firing automatically */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	float FireRate;
 
@@ -115,7 +130,30 @@ public:
 	float BaseDamage;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
-	USoundBase* AttackSound;
+	TSoftObjectPtr<USoundBase> AttackSound;
+
+	/** Half angle in degrees of the cone shots spread into */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Spread", meta = (ClampMin = 0))
+	float SpreadAngle = 0.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Spread", meta = (ClampMin = 1))
+	int32 PelletCount = 1;
+
+	/** Aim kick in degrees (pitch, yaw) for each shot of a burst, the last entry repeats */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Recoil")
+	TArray<FVector2D> RecoilPattern;
+
+	/** Seeded random variation in degrees added to every recoil step */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Recoil", meta = (ClampMin = 0))
+	float RecoilJitter = 0.f;
+};
+
+UENUM(BlueprintType)
+enum class EProjectileSimulationMode : uint8
+{
+	Actor UMETA(DisplayName = "Actor"),
+	Batched UMETA(DisplayName = "Batched"),
+	Virtual UMETA(DisplayName = "Virtual"),
 };
 
 UCLASS(BlueprintType, Blueprintable)
@@ -140,7 +178,7 @@ public:
 	float MaxSpeed = 3000.f;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
-	UStaticMesh* StaticMesh;
+	TSoftObjectPtr<UStaticMesh> StaticMesh;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	TArray<TSubclassOf<UGameplayEffect>> Effects;
@@ -152,8 +190,78 @@ public:
 	TEnumAsByte<ETraceTypeQuery> RadialDamageTraceType;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
-	class UNiagaraSystem* OnStopVFX =  nullptr;
+	TSoftObjectPtr<class UNiagaraSystem> OnStopVFX;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
-	USoundBase* OnStopSFX = nullptr;
-};
\ No newline at end of file
+	TSoftObjectPtr<USoundBase> OnStopSFX;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Simulation")
+	EProjectileSimulationMode SimulationMode = EProjectileSimulationMode::Actor;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Simulation")
+	float CollisionRadius = 10.f;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Simulation")
+	float MaxLifetime = 10.f;
+
+	/** Integrate in fixed steps so the trajectory and impact point do not depend on the frame rate, the mesh is drawn interpolated between steps */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Simulation")
+	bool bUseFixedTimestep = false;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Simulation", meta = (EditCondition = "bUseFixedTimestep", ClampMin = "0.001"))
+	float FixedTimestep = 1.f / 60.f;
+
+	/** Steps beyond this in one frame are dropped instead of letting a hitch snowball */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Simulation", meta = (EditCondition = "bUseFixedTimestep", ClampMin = "1", ClampMax = "25"))
+	int32 MaxSubsteps = 8;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Pooling")
+	int32 PoolLowWatermark = 4;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Pooling")
+	int32 PoolHighWatermark = 32;
+};
+
+USTRUCT(BlueprintType)
+struct FBallisticQuery
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FVector Origin = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FVector Target = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	FVector TargetVelocity = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	TSubclassOf<UProjectileStaticData> ProjectileDataClass;
+
+	/** Ignored by the verification sweep, usually the actor being aimed at */
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	AActor* TargetActor = nullptr;
+};
+
+USTRUCT(BlueprintType)
+struct FBallisticSolution
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	bool bHasSolution = false;
+
+	/** Only set when verification was requested and the arc hit something before reaching the target */
+	UPROPERTY(BlueprintReadOnly)
+	bool bBlocked = false;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector LaunchVelocity = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly)
+	FVector InterceptLocation = FVector::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly)
+	float FlightTime = 0.f;
+};
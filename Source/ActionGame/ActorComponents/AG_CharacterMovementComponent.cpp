@@ -6,6 +6,7 @@
 #include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
 #include "ActionGameTypes.h"
+#include "ActionGameGameplayTags.h"
 
 static TAutoConsoleVariable<int32> CVarShowTraversal(
 	TEXT("ShowDebugTraversal"),
@@ -43,7 +44,7 @@ void UAG_CharacterMovementComponent::BeginPlay()
 
 	if (UAbilitySystemComponent* AbilityComponent = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(GetOwner()))
 	{
-		AbilityComponent->RegisterGameplayTagEvent(FGameplayTag::RequestGameplayTag(TEXT("Movement.Enforced.Strafe"), EGameplayTagEventType::NewOrRemoved)).AddUObject(this, &UAG_CharacterMovementComponent::OnEnforcedStrafeTagChanged);
+		AbilityComponent->RegisterGameplayTagEvent(FActionGameGameplayTags::Get().MovementEnforcedStrafeTag, EGameplayTagEventType::NewOrRemoved).AddUObject(this, &UAG_CharacterMovementComponent::OnEnforcedStrafeTagChanged);
 	}
 }
 
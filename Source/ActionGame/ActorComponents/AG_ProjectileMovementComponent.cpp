@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AG_ProjectileMovementComponent.h"
+
+void UAG_ProjectileMovementComponent::SetFixedTimestep(float InFixedTimestep, int32 InMaxSubsteps)
+{
+	FixedTimestep = InFixedTimestep > 0.f ? FMath::Max(InFixedTimestep, 0.001f) : 0.f;
+	MaxSubsteps = FMath::Max(InMaxSubsteps, 1);
+	StepAccumulator = 0.f;
+
+	// Whole steps are split at exactly the step length, the extra iteration absorbs float error in the remainder
+	bForceSubStepping = FixedTimestep > 0.f;
+
+	if (bForceSubStepping)
+	{
+		MaxSimulationTimeStep = FixedTimestep;
+		MaxSimulationIterations = FMath::Min(MaxSubsteps + 1, 25);
+	}
+
+	UpdateVisualOffset();
+}
+
+void UAG_ProjectileMovementComponent::SetVisualComponent(USceneComponent* InVisualComponent)
+{
+	VisualComponent = InVisualComponent;
+}
+
+void UAG_ProjectileMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	if (FixedTimestep <= 0.f)
+	{
+		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+		return;
+	}
+
+	StepAccumulator += DeltaTime;
+
+	const int32 Steps = FMath::Min(FMath::FloorToInt(StepAccumulator / FixedTimestep), MaxSubsteps);
+
+	// Drop whatever did not fit in MaxSubsteps rather than carrying it into the next frame
+	StepAccumulator = FMath::Min(StepAccumulator - Steps * FixedTimestep, FixedTimestep);
+
+	if (Steps > 0)
+	{
+		Super::TickComponent(Steps * FixedTimestep, TickType, ThisTickFunction);
+	}
+
+	UpdateVisualOffset();
+}
+
+void UAG_ProjectileMovementComponent::UpdateVisualOffset()
+{
+	if (!VisualComponent) return;
+
+	// Stopping clears the updated component, the projectile is then drawn where it stopped
+	if (!UpdatedComponent)
+	{
+		VisualComponent->SetRelativeLocation(FVector::ZeroVector);
+		return;
+	}
+
+	// Lags one step behind the simulation and catches up as the next step comes due
+	const float Alpha = FixedTimestep > 0.f ? StepAccumulator / FixedTimestep : 1.f;
+
+	const FVector WorldOffset = -Velocity * FixedTimestep * (1.f - Alpha);
+
+	VisualComponent->SetRelativeLocation(UpdatedComponent->GetComponentTransform().InverseTransformVectorNoScale(WorldOffset));
+}
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "AG_ProjectileMovementComponent.generated.h"
+
+/**
+ * Projectile movement that can advance in whole fixed steps, carrying the rest of the frame over to the next one.
+ * The steps are split by the movement component's own sub-stepping, so the flight does not depend on the frame rate.
+ */
+UCLASS()
+class ACTIONGAME_API UAG_ProjectileMovementComponent : public UProjectileMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	/** A zero timestep moves by the frame's delta as usual */
+	void SetFixedTimestep(float InFixedTimestep, int32 InMaxSubsteps);
+
+	/** Drawn partway through the last fixed step, the way the batched simulation interpolates its instances */
+	void SetVisualComponent(USceneComponent* InVisualComponent);
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	void UpdateVisualOffset();
+
+	float FixedTimestep = 0.f;
+
+	int32 MaxSubsteps = 1;
+
+	float StepAccumulator = 0.f;
+
+	UPROPERTY()
+	TObjectPtr<USceneComponent> VisualComponent = nullptr;
+};
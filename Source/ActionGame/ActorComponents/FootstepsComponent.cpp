@@ -3,7 +3,7 @@
 
 #include "FootstepsComponent.h"
 #include "PhysicalMaterials/AG_PhysicalMaterial.h"
-#include "Kismet/GameplayStatics.h"
+#include "Subsystems/CosmeticEffectsSubsystem.h"
 #include "ActionGameCharacter.h"
 #include "DrawDebugHelpers.h"
 
@@ -38,6 +38,11 @@ void UFootstepsComponent::BeginPlay()
 
 void UFootstepsComponent::HandleFootstep(EFoot Foot)
 {
+	UCosmeticEffectsSubsystem* CosmeticEffects = UCosmeticEffectsSubsystem::Get(this);
+
+	// Footsteps are purely cosmetic, so skip the surface trace where nothing can be heard
+	if (!CosmeticEffects) return;
+
 	if (AActionGameCharacter* Character = Cast<AActionGameCharacter>(GetOwner()))
 	{
 		const int32 DebugShowFootsteps = CVarShowFootsteps.GetValueOnAnyThread();
@@ -58,16 +63,11 @@ void UFootstepsComponent::HandleFootstep(EFoot Foot)
 				{
 					if (HitResult.PhysMaterial.Get())
 					{
-						UAG_PhysicalMaterial* PhysicalMaterial = Cast<UAG_PhysicalMaterial>(HitResult.PhysMaterial.Get());
-
-						if (PhysicalMaterial)
-						{
-							UGameplayStatics::PlaySoundAtLocation(this, PhysicalMaterial->FootstepSound, Location, 1.f);
-						}
+						CosmeticEffects->PlaySurfaceEffect(HitResult.PhysMaterial.Get(), ESurfaceEffectType::Footstep, Location, FRotator::ZeroRotator, Character);
 
 						if (DebugShowFootsteps > 0)
 						{
-							DrawDebugString(GetWorld(), Location, GetNameSafe(PhysicalMaterial), nullptr, FColor::White, 4.f);
+							DrawDebugString(GetWorld(), Location, GetNameSafe(CosmeticEffects->GetSurfaceMaterial(HitResult.PhysMaterial.Get())), nullptr, FColor::White, 4.f);
 						}
 					}
 
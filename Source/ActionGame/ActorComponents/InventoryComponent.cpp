@@ -9,14 +9,10 @@
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemBlueprintLibrary.h"
 #include "Actors/ItemActor.h"
-#include "GameplayTagsManager.h"
-#include "Engine/ActorChannel.h"
+#include "ActionGameGameplayTags.h"
 #include "AbilitySystemLog.h"
-
-FGameplayTag UInventoryComponent::EquipItemActorTag;
-FGameplayTag UInventoryComponent::DropItemTag;
-FGameplayTag UInventoryComponent::EquipNextTag;
-FGameplayTag UInventoryComponent::UnequipTag;
+#include "ActionGameStatics.h"
+#include "Subsystems/DebugDrawSubsystem.h"
 
 static TAutoConsoleVariable<int32> CVarShowInventory(
 	TEXT("ShowDebugInventory"),
@@ -30,16 +26,12 @@ static TAutoConsoleVariable<int32> CVarShowInventory(
 // Sets default values for this component's properties
 UInventoryComponent::UInventoryComponent()
 {
-	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bCanEverTick = false;
 	bWantsInitializeComponent = true;
 	SetIsReplicatedByDefault(true);
+	bReplicateUsingRegisteredSubObjectList = true;
 
-	static bool bHandledAddingTags = false;
-	if (!bHandledAddingTags)
-	{
-		bHandledAddingTags = true;
-		UGameplayTagsManager::Get().OnLastChanceToAddNativeTags().AddUObject(this, &UInventoryComponent::AddInventoryTags);
-	}
+	InventoryList.OwnerComponent = this;
 }
 
 void UInventoryComponent::InitializeComponent()
@@ -50,56 +42,61 @@ void UInventoryComponent::InitializeComponent()
 	{
 		for (auto ItemClass : DefaultItems)
 		{
-			InventoryList.AddItem(ItemClass);
+			RegisterItem(InventoryList.AddItem(ItemClass));
 		}
 	}
 
 	if (UAbilitySystemComponent* ASC = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(GetOwner()))
 	{
-		ASC->GenericGameplayEventCallbacks.FindOrAdd(UInventoryComponent::EquipItemActorTag).AddUObject(this, &UInventoryComponent::GameplayEventCallback);
-		ASC->GenericGameplayEventCallbacks.FindOrAdd(UInventoryComponent::DropItemTag).AddUObject(this, &UInventoryComponent::GameplayEventCallback);
-		ASC->GenericGameplayEventCallbacks.FindOrAdd(UInventoryComponent::EquipNextTag).AddUObject(this, &UInventoryComponent::GameplayEventCallback);
-		ASC->GenericGameplayEventCallbacks.FindOrAdd(UInventoryComponent::UnequipTag).AddUObject(this, &UInventoryComponent::GameplayEventCallback);
+		ASC->GenericGameplayEventCallbacks.FindOrAdd(FActionGameGameplayTags::Get().EquipItemActorTag).AddUObject(this, &UInventoryComponent::GameplayEventCallback);
+		ASC->GenericGameplayEventCallbacks.FindOrAdd(FActionGameGameplayTags::Get().DropItemTag).AddUObject(this, &UInventoryComponent::GameplayEventCallback);
+		ASC->GenericGameplayEventCallbacks.FindOrAdd(FActionGameGameplayTags::Get().EquipNextTag).AddUObject(this, &UInventoryComponent::GameplayEventCallback);
+		ASC->GenericGameplayEventCallbacks.FindOrAdd(FActionGameGameplayTags::Get().UnequipTag).AddUObject(this, &UInventoryComponent::GameplayEventCallback);
 	}
 }
 
-bool UInventoryComponent::ReplicateSubobjects(UActorChannel* Channel, FOutBunch* Bunch, FReplicationFlags* RepFlags)
+void UInventoryComponent::BeginPlay()
 {
-	bool WroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
+	Super::BeginPlay();
 
-	for (FInventoryListItem& Item : InventoryList.GetItemsRef())
+	if (UDebugDrawSubsystem* DebugDraw = GetWorld()->GetSubsystem<UDebugDrawSubsystem>())
 	{
-		UInventoryItemInstance* ItemInstance = Item.ItemInstance;
-
-		if (IsValid(ItemInstance))
-		{
-			WroteSomething |= Channel->ReplicateSubobject(ItemInstance, *Bunch, *RepFlags);
-		}
+		DebugDraw->RegisterDebugDraw(this, CVarShowInventory.AsVariable(), FOnDebugDraw::CreateUObject(this, &UInventoryComponent::DrawDebugInventory));
 	}
-
-	return WroteSomething;
 }
 
-// Called every frame
-void UInventoryComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UInventoryComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-	const bool bShowDebug = CVarShowInventory.GetValueOnGameThread() != 0;
+	if (UDebugDrawSubsystem* DebugDraw = GetWorld()->GetSubsystem<UDebugDrawSubsystem>())
+	{
+		DebugDraw->UnregisterDebugDraw(this);
+	}
 
-	if (bShowDebug)
+	if (GetOwner()->HasAuthority())
 	{
 		for (FInventoryListItem& Item : InventoryList.GetItemsRef())
 		{
-			UInventoryItemInstance* ItemInstance = Item.ItemInstance;
-			const UItemStaticData* ItemStaticData = ItemInstance->GetItemStaticData();
-
-			if (IsValid(ItemInstance) && IsValid(ItemStaticData))
+			if (IsValid(Item.ItemInstance))
 			{
-				GEngine->AddOnScreenDebugMessage(-1, 0, FColor::Blue, FString::Printf(TEXT("Item: %s"), * ItemStaticData->Name.ToString()));
+				Item.ItemInstance->DestroyItemActor();
 			}
 		}
 	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UInventoryComponent::DrawDebugInventory() const
+{
+	for (const FInventoryListItem& Item : InventoryList.GetItems())
+	{
+		const UItemStaticData* ItemStaticData = UActionGameStatics::GetItemStaticData(Item.ItemStaticDataClass);
+
+		if (IsValid(ItemStaticData))
+		{
+			GEngine->AddOnScreenDebugMessage(-1, 0, FColor::Blue, FString::Printf(TEXT("Item: %s x%d"), *ItemStaticData->Name.ToString(), Item.StackCount));
+		}
+	}
 }
 
 void UInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -110,42 +107,167 @@ void UInventoryComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 	DOREPLIFETIME(UInventoryComponent, CurrentItem);
 }
 
+void UInventoryComponent::OnRep_CurrentItem(UInventoryItemInstance* OldItem)
+{
+	if (OldItem != CurrentItem)
+	{
+		OnEquippedItemChanged.Broadcast(OldItem, CurrentItem);
+	}
+}
+
+void UInventoryComponent::SetCurrentItem(UInventoryItemInstance* InItemInstance)
+{
+	UInventoryItemInstance* OldItem = CurrentItem;
+	CurrentItem = InItemInstance;
+
+	OnRep_CurrentItem(OldItem);
+}
+
+void UInventoryComponent::RegisterItem(UInventoryItemInstance* InItemInstance)
+{
+	if (InItemInstance)
+	{
+		AddReplicatedSubObject(InItemInstance, COND_OwnerOnly);
+
+		InItemInstance->RequestAssets();
+	}
+}
+
+void UInventoryComponent::UnregisterItem(UInventoryItemInstance* InItemInstance)
+{
+	if (InItemInstance)
+	{
+		RemoveReplicatedSubObject(InItemInstance);
+	}
+}
+
+void UInventoryComponent::HandleItemAdded(UInventoryItemInstance* InItemInstance)
+{
+	if (InItemInstance)
+	{
+		OnItemAdded.Broadcast(InItemInstance);
+	}
+}
+
+void UInventoryComponent::HandleItemRemoved(UInventoryItemInstance* InItemInstance)
+{
+	if (InItemInstance)
+	{
+		OnItemRemoved.Broadcast(InItemInstance);
+	}
+}
+
+void UInventoryComponent::HandleItemChanged(UInventoryItemInstance* InItemInstance)
+{
+	if (InItemInstance)
+	{
+		OnItemChanged.Broadcast(InItemInstance);
+	}
+}
+
+void UInventoryComponent::HandleStackChanged(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 StackCount)
+{
+	if (InItemStaticDataClass)
+	{
+		OnItemStackChanged.Broadcast(InItemStaticDataClass, StackCount);
+	}
+}
+
 void UInventoryComponent::AddItem(TSubclassOf<UItemStaticData> InItemStaticDataClass)
 {
 	if (GetOwner()->HasAuthority())
 	{
-		InventoryList.AddItem(InItemStaticDataClass);
+		if (UInventoryItemInstance* ItemInstance = InventoryList.AddItem(InItemStaticDataClass))
+		{
+			RegisterItem(ItemInstance);
+			HandleItemAdded(ItemInstance);
+		}
+		else
+		{
+			HandleStackChanged(InItemStaticDataClass, InventoryList.GetStackCount(InItemStaticDataClass));
+		}
 	}
 }
 
-void UInventoryComponent::AddItemInstance(UInventoryItemInstance* InItemInstance)
+bool UInventoryComponent::AddItemInstance(UInventoryItemInstance* InItemInstance)
 {
 	if (GetOwner()->HasAuthority())
 	{
-		InventoryList.AddItem(InItemInstance);
+		if (InventoryList.AddItem(InItemInstance))
+		{
+			RegisterItem(InItemInstance);
+			HandleItemAdded(InItemInstance);
+
+			return true;
+		}
 	}
+
+	return false;
 }
 
 void UInventoryComponent::RemoveItem(TSubclassOf<UItemStaticData> InItemStaticDataClass)
 {
 	if (GetOwner()->HasAuthority())
 	{
-		InventoryList.RemoveItem(InItemStaticDataClass);
+		if (UInventoryItemInstance* ItemInstance = InventoryList.RemoveItem(InItemStaticDataClass))
+		{
+			if (ItemInstance == CurrentItem)
+			{
+				UnequipItem();
+			}
+
+			UnregisterItem(ItemInstance);
+			ItemInstance->DestroyItemActor();
+
+			HandleItemRemoved(ItemInstance);
+		}
+		else
+		{
+			RemoveItemStack(InItemStaticDataClass, 1);
+		}
+	}
+}
+
+void UInventoryComponent::AddItemStack(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 Count)
+{
+	if (GetOwner()->HasAuthority())
+	{
+		InventoryList.AddStack(InItemStaticDataClass, Count);
+
+		HandleStackChanged(InItemStaticDataClass, InventoryList.GetStackCount(InItemStaticDataClass));
 	}
 }
 
+int32 UInventoryComponent::RemoveItemStack(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 Count)
+{
+	int32 Removed = 0;
+
+	if (GetOwner()->HasAuthority())
+	{
+		Removed = InventoryList.RemoveStack(InItemStaticDataClass, Count);
+
+		if (Removed > 0)
+		{
+			HandleStackChanged(InItemStaticDataClass, InventoryList.GetStackCount(InItemStaticDataClass));
+		}
+	}
+
+	return Removed;
+}
+
+int32 UInventoryComponent::GetItemStackCount(TSubclassOf<UItemStaticData> InItemStaticDataClass) const
+{
+	return InventoryList.GetStackCount(InItemStaticDataClass);
+}
+
 void UInventoryComponent::EquipItem(TSubclassOf<UItemStaticData> InItemStaticDataClass)
 {
 	if (GetOwner()->HasAuthority())
 	{
-		for (auto Item : InventoryList.GetItemsRef())
+		if (UInventoryItemInstance* ItemInstance = InventoryList.FindItem(InItemStaticDataClass))
 		{
-			if (Item.ItemInstance->ItemStaticDataClass == InItemStaticDataClass)
-			{
-				Item.ItemInstance->OnEquipped(GetOwner());
-				CurrentItem = Item.ItemInstance;
-				break;
-			}
+			ItemInstance->OnEquipped(GetOwner());
+			SetCurrentItem(ItemInstance);
 		}
 	}
 }
@@ -154,14 +276,10 @@ void UInventoryComponent::EquipItemInstance(UInventoryItemInstance* InItemInstan
 {
 	if (GetOwner()->HasAuthority())
 	{
-		for (auto Item : InventoryList.GetItemsRef())
+		if (InventoryList.Contains(InItemInstance))
 		{
-			if (Item.ItemInstance == InItemInstance)
-			{
-				Item.ItemInstance->OnEquipped(GetOwner());
-				CurrentItem = Item.ItemInstance;
-				break;
-			}
+			InItemInstance->OnEquipped(GetOwner());
+			SetCurrentItem(InItemInstance);
 		}
 	}
 }
@@ -173,7 +291,7 @@ void UInventoryComponent::UnequipItem()
 		if (IsValid(CurrentItem))
 		{
 			CurrentItem->OnUnequipped(GetOwner());
-			CurrentItem = nullptr;
+			SetCurrentItem(nullptr);
 		}
 	}
 }
@@ -184,35 +302,24 @@ void UInventoryComponent::DropItem()
 	{
 		if (IsValid(CurrentItem))
 		{
-			CurrentItem->OnDropped(GetOwner());
-			RemoveItem(CurrentItem->ItemStaticDataClass);
-			CurrentItem = nullptr;
+			UInventoryItemInstance* DroppedItem = CurrentItem;
+			DroppedItem->OnDropped(GetOwner());
+			SetCurrentItem(nullptr);
+
+			if (InventoryList.RemoveItem(DroppedItem))
+			{
+				UnregisterItem(DroppedItem);
+				HandleItemRemoved(DroppedItem);
+			}
 		}
 	}
 }
 
 void UInventoryComponent::EquipNext()
 {
-	TArray<FInventoryListItem>& Items = InventoryList.GetItemsRef();
-
-	const bool bNoItems = Items.Num() == 0;
-	const bool bOneAndEquipped = Items.Num() == 1 && CurrentItem;
-
-	if (bNoItems || bOneAndEquipped) return;
+	UInventoryItemInstance* TargetItem = InventoryList.FindNextEquippable(CurrentItem);
 
-	UInventoryItemInstance* TargetItem = CurrentItem;
-
-	for (auto Item : Items)
-	{
-		if (Item.ItemInstance->GetItemStaticData()->bCanBeEquipped)
-		{
-			if (Item.ItemInstance != CurrentItem)
-			{
-				TargetItem = Item.ItemInstance;
-				break;
-			}
-		}
-	}
+	if (!TargetItem) return;
 
 	if (CurrentItem)
 	{
@@ -230,6 +337,80 @@ UInventoryItemInstance* UInventoryComponent::GetEquippedItem() const
 	return CurrentItem;
 }
 
+void UInventoryComponent::SaveSnapshot(FInventorySnapshot& OutSnapshot) const
+{
+	const TArray<FInventoryListItem>& Items = InventoryList.GetItems();
+
+	OutSnapshot.Items.Reset(Items.Num());
+	OutSnapshot.EquippedIndex = INDEX_NONE;
+
+	for (const FInventoryListItem& Item : Items)
+	{
+		if (!Item.ItemStaticDataClass) continue;
+
+		if (CurrentItem && Item.ItemInstance == CurrentItem)
+		{
+			OutSnapshot.EquippedIndex = OutSnapshot.Items.Num();
+		}
+
+		FInventoryItemSnapshot& ItemSnapshot = OutSnapshot.Items.AddDefaulted_GetRef();
+		ItemSnapshot.ItemStaticDataClass = Item.ItemStaticDataClass;
+		ItemSnapshot.StackCount = Item.StackCount;
+		ItemSnapshot.StateFlags = Item.StateFlags;
+	}
+}
+
+void UInventoryComponent::LoadSnapshot(const FInventorySnapshot& InSnapshot)
+{
+	if (!GetOwner()->HasAuthority()) return;
+
+	UnequipItem();
+
+	for (FInventoryListItem& Item : InventoryList.GetItemsRef())
+	{
+		if (IsValid(Item.ItemInstance))
+		{
+			UnregisterItem(Item.ItemInstance);
+			Item.ItemInstance->DestroyItemActor();
+
+			HandleItemRemoved(Item.ItemInstance);
+		}
+		else
+		{
+			HandleStackChanged(Item.ItemStaticDataClass, 0);
+		}
+	}
+
+	InventoryList.Empty();
+
+	UInventoryItemInstance* EquippedItem = nullptr;
+
+	for (int32 Index = 0; Index < InSnapshot.Items.Num(); ++Index)
+	{
+		const FInventoryItemSnapshot& ItemSnapshot = InSnapshot.Items[Index];
+
+		if (UInventoryItemInstance* ItemInstance = InventoryList.AddSnapshotItem(ItemSnapshot))
+		{
+			RegisterItem(ItemInstance);
+			HandleItemAdded(ItemInstance);
+
+			if (Index == InSnapshot.EquippedIndex)
+			{
+				EquippedItem = ItemInstance;
+			}
+		}
+		else
+		{
+			HandleStackChanged(ItemSnapshot.ItemStaticDataClass, InventoryList.GetStackCount(ItemSnapshot.ItemStaticDataClass));
+		}
+	}
+
+	if (EquippedItem)
+	{
+		EquipItemInstance(EquippedItem);
+	}
+}
+
 void UInventoryComponent::GameplayEventCallback(const FGameplayEventData* Payload)
 {
 	ENetRole NetRole = GetOwnerRole();
@@ -244,18 +425,6 @@ void UInventoryComponent::GameplayEventCallback(const FGameplayEventData* Payloa
 	}
 }
 
-void UInventoryComponent::AddInventoryTags()
-{
-	UGameplayTagsManager& TagsManager = UGameplayTagsManager::Get();
-
-	UInventoryComponent::EquipItemActorTag = TagsManager.AddNativeGameplayTag(TEXT("Event.Inventory.EquipItemActor"), TEXT("Equip item from item actor event"));
-	UInventoryComponent::DropItemTag = TagsManager.AddNativeGameplayTag(TEXT("Event.Inventory.DropItem"), TEXT("Drop equipped item"));
-	UInventoryComponent::EquipNextTag = TagsManager.AddNativeGameplayTag(TEXT("Event.Inventory.EquipNext"), TEXT("Try equip next item"));
-	UInventoryComponent::UnequipTag = TagsManager.AddNativeGameplayTag(TEXT("Event.Inventory.Unequip"), TEXT("Unequip current item"));
-
-	TagsManager.OnLastChanceToAddNativeTags().RemoveAll(this);
-}
-
 void UInventoryComponent::HandleGameplayEventInternal(FGameplayEventData Payload)
 {
 	ENetRole NetRole = GetOwnerRole();
@@ -264,27 +433,44 @@ void UInventoryComponent::HandleGameplayEventInternal(FGameplayEventData Payload
 	{
 		FGameplayTag EventTag = Payload.EventTag;
 
-		if (EventTag == UInventoryComponent::EquipItemActorTag)
+		if (EventTag == FActionGameGameplayTags::Get().EquipItemActorTag)
 		{
 			if (const UInventoryItemInstance* ItemInstance = Cast<UInventoryItemInstance>(Payload.OptionalObject))
 			{
-				AddItemInstance(const_cast<UInventoryItemInstance*>(ItemInstance));
+				UInventoryItemInstance* PickedUpInstance = const_cast<UInventoryItemInstance*>(ItemInstance);
+				AItemActor* PickedUpActor = Cast<AItemActor>(const_cast<AActor*>(Payload.Instigator.Get()));
+
+				const UItemStaticData* ItemStaticData = PickedUpInstance->GetItemStaticData();
 
-				if (Payload.Instigator)
+				if (ItemStaticData && !ItemStaticData->RequiresInstance())
+				{
+					// Stacked items only live on as a count, the pickup is done with
+					AddItemStack(PickedUpInstance->ItemStaticDataClass, 1);
+
+					if (PickedUpActor)
+					{
+						PickedUpActor->Destroy();
+					}
+				}
+				else
 				{
-					const_cast<AActor*>(Payload.Instigator.Get())->Destroy();
+					// The picked up actor is kept as the item's actor instead of spawning a new one on equip
+					if (AddItemInstance(PickedUpInstance))
+					{
+						PickedUpInstance->OnPickedUp(GetOwner(), PickedUpActor);
+					}
 				}
 			}
 		}
-		else if (EventTag == UInventoryComponent::EquipNextTag)
+		else if (EventTag == FActionGameGameplayTags::Get().EquipNextTag)
 		{
 			EquipNext();
 		}
-		else if (EventTag == UInventoryComponent::DropItemTag)
+		else if (EventTag == FActionGameGameplayTags::Get().DropItemTag)
 		{
 			DropItem();
 		}
-		else if (EventTag == UInventoryComponent::UnequipTag)
+		else if (EventTag == FActionGameGameplayTags::Get().UnequipTag)
 		{
 			UnequipItem();
 		}
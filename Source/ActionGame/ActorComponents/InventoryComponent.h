@@ -10,6 +10,10 @@
 #include "Abilities/GameplayAbilityTypes.h"
 #include "InventoryComponent.generated.h"
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FInventoryItemDelegate, UInventoryItemInstance*, ItemInstance);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInventoryStackChangedDelegate, TSubclassOf<UItemStaticData>, ItemStaticDataClass, int32, StackCount);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FInventoryEquippedItemChangedDelegate, UInventoryItemInstance*, OldItem, UInventoryItemInstance*, NewItem);
+
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class ACTIONGAME_API UInventoryComponent : public UActorComponent
 {
@@ -20,18 +24,30 @@ public:
 	UInventoryComponent();
 
 	virtual void InitializeComponent() override;
-	virtual bool ReplicateSubobjects(class UActorChannel* Channel, class FOutBunch* Bunch, FReplicationFlags* RepFlags) override;
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	UFUNCTION(BlueprintCallable)
 	void AddItem(TSubclassOf<UItemStaticData> InItemStaticDataClass);
 
+	/** Returns false if the instance was not added, for example when it is already in the inventory */
 	UFUNCTION(BlueprintCallable)
-	void AddItemInstance(UInventoryItemInstance* InItemInstance);
+	bool AddItemInstance(UInventoryItemInstance* InItemInstance);
 
 	UFUNCTION(BlueprintCallable)
 	void RemoveItem(TSubclassOf<UItemStaticData> InItemStaticDataClass);
 
+	UFUNCTION(BlueprintCallable)
+	void AddItemStack(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 Count);
+
+	/** Returns how many items were actually removed */
+	UFUNCTION(BlueprintCallable)
+	int32 RemoveItemStack(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 Count);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	int32 GetItemStackCount(TSubclassOf<UItemStaticData> InItemStaticDataClass) const;
+
 	UFUNCTION(BlueprintCallable)
 	void EquipItem(TSubclassOf<UItemStaticData> InItemStaticDataClass);
 
@@ -52,15 +68,31 @@ public:
 
 	virtual void GameplayEventCallback(const FGameplayEventData* Payload);
 
-	static FGameplayTag EquipItemActorTag;
-	static FGameplayTag DropItemTag;
-	static FGameplayTag EquipNextTag;
-	static FGameplayTag UnequipTag;
+	const FInventoryList& GetInventoryList() const { return InventoryList; }
 
-protected:
+	void SaveSnapshot(FInventorySnapshot& OutSnapshot) const;
 
-	UFUNCTION()
-	void AddInventoryTags();
+	/** Replaces the whole inventory with a saved one and equips the item that was equipped when it was saved */
+	void LoadSnapshot(const FInventorySnapshot& InSnapshot);
+
+	/** Fired on the server and on clients as the inventory actually changes, so listeners never have to poll it */
+	UPROPERTY(BlueprintAssignable)
+	FInventoryItemDelegate OnItemAdded;
+
+	UPROPERTY(BlueprintAssignable)
+	FInventoryItemDelegate OnItemRemoved;
+
+	UPROPERTY(BlueprintAssignable)
+	FInventoryItemDelegate OnItemChanged;
+
+	/** Stacked items have no instance, listeners get the new total count of the item instead */
+	UPROPERTY(BlueprintAssignable)
+	FInventoryStackChangedDelegate OnItemStackChanged;
+
+	UPROPERTY(BlueprintAssignable)
+	FInventoryEquippedItemChangedDelegate OnEquippedItemChanged;
+
+protected:
 
 	UPROPERTY(Replicated)
 	FInventoryList InventoryList;
@@ -68,9 +100,23 @@ protected:
 	UPROPERTY(EditDefaultsOnly)
 	TArray<TSubclassOf<UItemStaticData>> DefaultItems;
 
-	UPROPERTY(Replicated)
+	UPROPERTY(ReplicatedUsing = OnRep_CurrentItem)
 	UInventoryItemInstance* CurrentItem = nullptr;
 
+	UFUNCTION()
+	void OnRep_CurrentItem(UInventoryItemInstance* OldItem);
+
+	void SetCurrentItem(UInventoryItemInstance* InItemInstance);
+
+	/** Carried items only replicate to the owner through the inventory, the item actor replicates them to everyone else while it is awake */
+	void RegisterItem(UInventoryItemInstance* InItemInstance);
+	void UnregisterItem(UInventoryItemInstance* InItemInstance);
+
+	void HandleItemAdded(UInventoryItemInstance* InItemInstance);
+	void HandleItemRemoved(UInventoryItemInstance* InItemInstance);
+	void HandleItemChanged(UInventoryItemInstance* InItemInstance);
+	void HandleStackChanged(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 StackCount);
+
 	FDelegateHandle TagDelegateHandle;
 
 	void HandleGameplayEventInternal(FGameplayEventData Payload);
@@ -78,8 +124,8 @@ protected:
 	UFUNCTION(Server, Reliable)
 	void ServerHandleGameplayEvent(FGameplayEventData Payload);
 
-public:	
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	void DrawDebugInventory() const;
+
+	friend struct FInventoryListItem;
 
 };
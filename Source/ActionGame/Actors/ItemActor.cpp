@@ -3,20 +3,23 @@
 
 #include "ItemActor.h"
 #include "Inventory/InventoryItemInstance.h"
-#include "Engine/ActorChannel.h"
 #include "Net/UnrealNetwork.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Components/SphereComponent.h"
 #include "ActorComponents/InventoryComponent.h"
 #include "AbilitySystemBlueprintLibrary.h"
+#include "ActionGameGameplayTags.h"
+#include "ActionGameStatics.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/WorldItemSubsystem.h"
 
 // Sets default values
 AItemActor::AItemActor()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
 	bReplicates = true;
 	SetReplicateMovement(true);
+	bReplicateUsingRegisteredSubObjectList = true;
 
 	SphereComponent = CreateDefaultSubobject<USphereComponent>(TEXT("SphereComponent"));
 	SphereComponent->SetupAttachment(RootComponent);
@@ -25,17 +28,36 @@ AItemActor::AItemActor()
 
 void AItemActor::Init(UInventoryItemInstance* InInstance)
 {
-	ItemInstance = InInstance;
+	SetItemInstance(InInstance);
 
 	InitInternal();
 }
 
+void AItemActor::SetItemInstance(UInventoryItemInstance* InInstance)
+{
+	if (IsValid(ItemInstance))
+	{
+		RemoveReplicatedSubObject(ItemInstance);
+	}
+
+	ItemInstance = InInstance;
+
+	// Replicates to every client that has this actor, the owner also receives it through its inventory
+	if (IsValid(ItemInstance))
+	{
+		AddReplicatedSubObject(ItemInstance);
+	}
+}
+
 void AItemActor::OnEquipped()
 {
 	ItemState = EItemState::Equipped;
 
 	SphereComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	SphereComponent->SetGenerateOverlapEvents(false);
+
+	SetActorHiddenInGame(false);
+	SetNetDormancy(DORM_Awake);
 }
 
 void AItemActor::OnUnequipped()
@@ -44,12 +66,19 @@ void AItemActor::OnUnequipped()
 
 	SphereComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	SphereComponent->SetGenerateOverlapEvents(false);
+
+	// Stowed items stay attached to their owner, hidden and dormant until equipped again
+	SetActorHiddenInGame(true);
+	SetNetDormancy(DORM_DormantAll);
 }
 
 void AItemActor::OnDropped()
 {
 	ItemState = EItemState::Dropped;
 
+	SetActorHiddenInGame(false);
+	SetNetDormancy(DORM_Awake);
+
 	GetRootComponent()->DetachFromComponent(FDetachmentTransformRules::KeepWorldTransform);
 
 	if (AActor* ActorOwner = GetOwner())
@@ -85,6 +114,14 @@ void AItemActor::OnDropped()
 
 	SphereComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 	SphereComponent->SetGenerateOverlapEvents(true);
+
+	if (HasAuthority())
+	{
+		if (UWorldItemSubsystem* WorldItems = GetWorld()->GetSubsystem<UWorldItemSubsystem>())
+		{
+			WorldItems->TrackItemActor(this);
+		}
+	}
 }
 
 void AItemActor::OnRep_ItemState()
@@ -92,6 +129,7 @@ void AItemActor::OnRep_ItemState()
 	switch (ItemState)
 	{
 	case EItemState::Equipped:
+	case EItemState::None:
 		SphereComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 		SphereComponent->SetGenerateOverlapEvents(false);
 		break;
@@ -109,21 +147,12 @@ void AItemActor::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActo
 		FGameplayEventData EventPayload;
 		EventPayload.Instigator = this;
 		EventPayload.OptionalObject = ItemInstance;
-		EventPayload.EventTag = UInventoryComponent::EquipItemActorTag;
+		EventPayload.EventTag = FActionGameGameplayTags::Get().EquipItemActorTag;
 
-		UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(OtherActor, UInventoryComponent::EquipItemActorTag, EventPayload);
+		UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(OtherActor, FActionGameGameplayTags::Get().EquipItemActorTag, EventPayload);
 	}
 }
 
-bool AItemActor::ReplicateSubobjects(UActorChannel* Channel, FOutBunch* Bunch, FReplicationFlags* RepFlags)
-{
-	bool WroteSomething = Super::ReplicateSubobjects(Channel, Bunch, RepFlags);
-
-	WroteSomething |= Channel->ReplicateSubobject(ItemInstance, *Bunch, *RepFlags);
-
-	return WroteSomething;
-}
-
 void AItemActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
@@ -136,19 +165,40 @@ void AItemActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifeti
 void AItemActor::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// Clients only have the pickup while it is relevant to them, which already means near.
+	// A dedicated server has nothing to show and streams the content once the item is in an inventory.
+	if (!HasAuthority())
+	{
+		RequestItemAssets();
+	}
+	else if (GetNetMode() != NM_DedicatedServer && !GetOwner())
+	{
+		// A host has its pickups from map load, the world item subsystem requests them as local players come near
+		if (UWorldItemSubsystem* WorldItems = GetWorld()->GetSubsystem<UWorldItemSubsystem>())
+		{
+			WorldItems->TrackPrefetch(this);
+		}
+	}
 	
 	if (HasAuthority())
 	{
 		if (!IsValid(ItemInstance) && IsValid(ItemStaticDataClass))
 		{
-			ItemInstance = NewObject<UInventoryItemInstance>();
-			ItemInstance->Init(ItemStaticDataClass);
+			UInventoryItemInstance* NewInstance = NewObject<UInventoryItemInstance>();
+			NewInstance->Init(ItemStaticDataClass);
 
-			SphereComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-			SphereComponent->SetGenerateOverlapEvents(true);
+			SetItemInstance(NewInstance);
 
 			InitInternal();
 		}
+
+		// Pickups, new or given back the instance a world item record kept, unlike items spawned for their owner
+		if (IsValid(ItemInstance) && !GetOwner())
+		{
+			SphereComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+			SphereComponent->SetGenerateOverlapEvents(true);
+		}
 	}
 }
 
@@ -156,19 +206,27 @@ void AItemActor::OnRep_ItemInstance(UInventoryItemInstance* OldItemInstance)
 {
 	if (IsValid(ItemInstance) && !IsValid(OldItemInstance))
 	{
+		RequestItemAssets();
+
 		InitInternal();
 	}
 }
 
-void AItemActor::InitInternal()
+TSubclassOf<UItemStaticData> AItemActor::GetItemStaticDataClass() const
 {
+	return IsValid(ItemInstance) ? ItemInstance->ItemStaticDataClass : ItemStaticDataClass;
+}
 
+void AItemActor::RequestItemAssets()
+{
+	if (!AssetsHandle.IsValid())
+	{
+		AssetsHandle = UActionGameStatics::RequestStaticDataAssets(GetItemStaticDataClass());
+	}
 }
 
-// Called every frame
-void AItemActor::Tick(float DeltaTime)
+void AItemActor::InitInternal()
 {
-	Super::Tick(DeltaTime);
 
 }
 
@@ -10,6 +10,7 @@
 #include "ItemActor.generated.h"
 
 class UInventoryItemInstance;
+struct FStreamableHandle;
 
 UCLASS()
 class ACTIONGAME_API AItemActor : public AActor
@@ -23,8 +24,21 @@ public:
 	virtual void OnEquipped();
 	virtual void OnUnequipped();
 	virtual void OnDropped();
-	virtual bool ReplicateSubobjects(class UActorChannel* Channel, class FOutBunch* Bunch, FReplicationFlags* RepFlags) override;
 
+	bool IsDropped() const { return ItemState == EItemState::Dropped; }
+
+	/** Dropped items and items nobody has picked up yet */
+	bool IsUnclaimed() const { return IsDropped() || !GetOwner(); }
+
+	TSubclassOf<UItemStaticData> GetItemStaticDataClass() const;
+
+	UInventoryItemInstance* GetItemInstance() const { return ItemInstance; }
+
+	/** Starts loading the item's content once a player is near, before anyone can pick it up */
+	void RequestItemAssets();
+
+	/** Sets the item a spawned pickup creates its instance from, must be called before it begins play */
+	void SetItemStaticDataClass(TSubclassOf<UItemStaticData> InItemStaticDataClass) { ItemStaticDataClass = InItemStaticDataClass; }
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const;
 
 	void Init(UInventoryItemInstance* InInstance);
@@ -39,6 +53,8 @@ protected:
 	UFUNCTION()
 	void OnRep_ItemInstance(UInventoryItemInstance* OldItemInstance);
 
+	void SetItemInstance(UInventoryItemInstance* InInstance);
+
 	UPROPERTY(ReplicatedUsing = OnRep_ItemState)
 	EItemState ItemState = EItemState::None;
 
@@ -56,8 +72,5 @@ protected:
 
 	virtual void InitInternal();
 
-public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
+	TSharedPtr<FStreamableHandle> AssetsHandle;
 };
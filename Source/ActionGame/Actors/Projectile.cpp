@@ -2,11 +2,18 @@
 
 
 #include "Projectile.h"
-#include "GameFramework/ProjectileMovementComponent.h"
+#include "ActorComponents/AG_ProjectileMovementComponent.h"
+#include "Components/SphereComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "ActionGameStatics.h"
 #include "Net/UnrealNetwork.h"
-#include "NiagaraFunctionLibrary.h"
+#include "Subsystems/ProjectilePoolSubsystem.h"
+#include "Subsystems/ProjectileSimulationSubsystem.h"
+#include "Subsystems/CosmeticEffectsSubsystem.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/AssetManager.h"
+#include "NiagaraSystem.h"
+#include "Sound/SoundBase.h"
 
 static TAutoConsoleVariable<int32> CVarShowProjectiles(
 	TEXT("ShowDebugProjectiles"),
@@ -25,7 +32,13 @@ AProjectile::AProjectile()
 	SetReplicateMovement(true);
 	bReplicates = true;
 
-	ProjectileMovementComponent = CreateDefaultSubobject<UProjectileMovementComponent>(TEXT("ProjectileMovement"));
+	CollisionComponent = CreateDefaultSubobject<USphereComponent>(TEXT("Collision"));
+	CollisionComponent->InitSphereRadius(10.f);
+	CollisionComponent->SetCollisionProfileName(TEXT("Projectile"));
+
+	SetRootComponent(CollisionComponent);
+
+	ProjectileMovementComponent = CreateDefaultSubobject<UAG_ProjectileMovementComponent>(TEXT("ProjectileMovement"));
 
 	ProjectileMovementComponent->ProjectileGravityScale = 0.f;
 	ProjectileMovementComponent->Velocity = FVector::ZeroVector;
@@ -35,7 +48,7 @@ AProjectile::AProjectile()
 
 	StaticMeshComponent->SetupAttachment(GetRootComponent());
 	StaticMeshComponent->SetIsReplicated(true);
-	StaticMeshComponent->SetCollisionProfileName(TEXT("Projectile"));
+	StaticMeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	StaticMeshComponent->bReceivesDecals = false;
 }
 
@@ -53,15 +66,107 @@ const UProjectileStaticData* AProjectile::GetProjectileStaticData() const
 void AProjectile::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// Pooled projectiles reach clients dormant, long before they are first fired
+	if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
+	{
+		ProjectileSimulation->RequestProjectileAssets(ProjectileDataClass);
+	}
+
+	if (bIsActive)
+	{
+		InitFromProjectileData();
+	}
+	else
+	{
+		SetProjectileEnabled(false);
+	}
+
+	// Nothing is drawn on a dedicated server, so there is no point moving the mesh between steps
+	if (GetNetMode() != NM_DedicatedServer)
+	{
+		ProjectileMovementComponent->SetVisualComponent(StaticMeshComponent);
+	}
+}
+
+void AProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (bIsActive)
+	{
+		PlayStopEffects();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AProjectile::ActivateProjectile(const FTransform& Transform, AActor* InOwner, APawn* InInstigator)
+{
+	SetNetDormancy(DORM_Awake);
+
+	SetOwner(InOwner);
+	SetInstigator(InInstigator);
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+
+	bIsActive = true;
+	++ActivationCount;
+
+	InitFromProjectileData();
+
+	ForceNetUpdate();
+}
+
+void AProjectile::DeactivateProjectile()
+{
+	if (!bIsActive) return;
+
+	PlayStopEffects();
+
+	bIsActive = false;
+	++ActivationCount;
+
+	SetProjectileEnabled(false);
+
+	// Send the deactivation before the channel goes dormant rather than leaving it to the count on reuse
+	ForceNetUpdate();
+
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AProjectile::OnRep_ActivationCount(uint8 PreviousActivationCount)
+{
+	// An even number of transitions means a whole life, or the gap between two, was never seen
+	const bool bMissedLife = (static_cast<uint8>(ActivationCount - PreviousActivationCount) & 1) == 0;
+
+	if (bIsActive)
+	{
+		// Also restarts a projectile whose deactivation was missed, its previous flight is simply replaced
+		InitFromProjectileData();
+	}
+	else if (!bMissedLife)
+	{
+		PlayStopEffects();
+
+		SetProjectileEnabled(false);
+	}
+}
+
+void AProjectile::InitFromProjectileData()
+{
 	const UProjectileStaticData* ProjectileData = GetProjectileStaticData();
 
 	if (ProjectileData && ProjectileMovementComponent)
 	{
-		if (ProjectileData->StaticMesh)
+		if (ProjectileData->StaticMesh.IsValid() || ProjectileData->StaticMesh.IsNull())
 		{
-			StaticMeshComponent->SetStaticMesh(ProjectileData->StaticMesh);
+			UpdateStaticMesh();
 		}
+		else
+		{
+			UAssetManager::GetStreamableManager().RequestAsyncLoad(ProjectileData->StaticMesh.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &AProjectile::UpdateStaticMesh));
+		}
+
+		// Same radius the batched simulation and the ballistic solver sweep with
+		CollisionComponent->SetSphereRadius(ProjectileData->CollisionRadius);
 
 		ProjectileMovementComponent->bInitialVelocityInLocalSpace = false;
 		ProjectileMovementComponent->InitialSpeed = ProjectileData->InitialSpeed;
@@ -71,8 +176,14 @@ void AProjectile::BeginPlay()
 		ProjectileMovementComponent->Bounciness = 0.f;
 		ProjectileMovementComponent->ProjectileGravityScale = ProjectileData->GravityMultiplyer;
 
-		ProjectileMovementComponent->Velocity = ProjectileData->InitialSpeed * GetActorForwardVector();
+		ProjectileMovementComponent->SetFixedTimestep(ProjectileData->bUseFixedTimestep ? ProjectileData->FixedTimestep : 0.f, ProjectileData->MaxSubsteps);
 	}
+	else if (ProjectileMovementComponent)
+	{
+		ProjectileMovementComponent->SetFixedTimestep(0.f, 1);
+	}
+
+	SetProjectileEnabled(true);
 
 	const int32 DebugShowProjectile = CVarShowProjectiles.GetValueOnAnyThread();
 
@@ -82,18 +193,54 @@ void AProjectile::BeginPlay()
 	}
 }
 
-void AProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+void AProjectile::UpdateStaticMesh()
 {
 	const UProjectileStaticData* ProjectileData = GetProjectileStaticData();
+	UStaticMesh* StaticMesh = ProjectileData ? ProjectileData->StaticMesh.Get() : nullptr;
 
-	if (ProjectileData)
+	if (StaticMesh && StaticMeshComponent->GetStaticMesh() != StaticMesh)
+	{
+		StaticMeshComponent->SetStaticMesh(StaticMesh);
+	}
+}
+
+void AProjectile::SetProjectileEnabled(bool bEnabled)
+{
+	SetActorHiddenInGame(!bEnabled);
+	SetActorEnableCollision(bEnabled);
+
+	if (ProjectileMovementComponent)
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, ProjectileData->OnStopSFX, GetActorLocation());
+		if (bEnabled)
+		{
+			const UProjectileStaticData* ProjectileData = GetProjectileStaticData();
+
+			ProjectileMovementComponent->SetUpdatedComponent(GetRootComponent());
+			ProjectileMovementComponent->Velocity = ProjectileData ? ProjectileData->InitialSpeed * GetActorForwardVector() : FVector::ZeroVector;
+			ProjectileMovementComponent->UpdateComponentVelocity();
+		}
+		else
+		{
+			ProjectileMovementComponent->StopMovementImmediately();
+		}
 
-		UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, ProjectileData->OnStopVFX, GetActorLocation());
+		ProjectileMovementComponent->SetComponentTickEnabled(bEnabled);
 	}
+}
 
-	Super::EndPlay(EndPlayReason);
+void AProjectile::PlayStopEffects() const
+{
+	const UProjectileStaticData* ProjectileData = GetProjectileStaticData();
+
+	UCosmeticEffectsSubsystem* CosmeticEffects = UCosmeticEffectsSubsystem::Get(this);
+
+	if (ProjectileData && CosmeticEffects)
+	{
+		// Kept loaded by the projectile simulation subsystem, nothing plays rather than hitching if they have not streamed in yet
+		CosmeticEffects->PlaySoundAtLocation(ProjectileData->OnStopSFX.Get(), GetActorLocation());
+
+		CosmeticEffects->SpawnSystemAtLocation(ProjectileData->OnStopVFX.Get(), GetActorLocation());
+	}
 }
 
 void AProjectile::DebugDrawPath() const
@@ -135,7 +282,16 @@ void AProjectile::OnProjectileStop(const FHitResult& ImpactResult)
 		);
 	}
 
-	Destroy();
+	UProjectilePoolSubsystem* ProjectilePool = HasAuthority() ? GetWorld()->GetSubsystem<UProjectilePoolSubsystem>() : nullptr;
+
+	if (ProjectilePool)
+	{
+		ProjectilePool->ReleaseProjectile(this);
+	}
+	else
+	{
+		Destroy();
+	}
 }
 
 void AProjectile::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -143,5 +299,7 @@ void AProjectile::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifet
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(AProjectile, ProjectileDataClass);
+	DOREPLIFETIME(AProjectile, bIsActive);
+	DOREPLIFETIME(AProjectile, ActivationCount);
 }
 
@@ -21,6 +21,12 @@ public:
 	UPROPERTY(BlueprintReadOnly, Replicated)
 	TSubclassOf<UProjectileStaticData> ProjectileDataClass;
 
+	void ActivateProjectile(const FTransform& Transform, AActor* InOwner, APawn* InInstigator);
+
+	void DeactivateProjectile();
+
+	FORCEINLINE bool IsProjectileActive() const { return bIsActive; }
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
@@ -28,7 +34,11 @@ protected:
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UPROPERTY()
-	class UProjectileMovementComponent* ProjectileMovementComponent = nullptr;
+	class UAG_ProjectileMovementComponent* ProjectileMovementComponent = nullptr;
+
+	/** Root the movement sweeps, so the mesh can be drawn between fixed steps */
+	UPROPERTY()
+	class USphereComponent* CollisionComponent = nullptr;
 
 	void DebugDrawPath() const;
 
@@ -38,6 +48,29 @@ protected:
 	UFUNCTION()
 	void OnProjectileStop(const FHitResult& ImpactResult);
 
+	UPROPERTY(Replicated)
+	bool bIsActive = true;
+
+	/**
+	 * Bumped on every activation and deactivation. A pooled projectile can go dormant and be reused before its
+	 * deactivation reaches a client, the count still tells the client a whole life passed when bIsActive looks unchanged.
+	 */
+	UPROPERTY(ReplicatedUsing = OnRep_ActivationCount)
+	uint8 ActivationCount = 0;
+
+	UFUNCTION()
+	void OnRep_ActivationCount(uint8 PreviousActivationCount);
+
+	void InitFromProjectileData();
+
+	/** Sets the data's mesh once it has streamed in, a projectile fired before that flies without one */
+	void UpdateStaticMesh();
+
+	void SetProjectileEnabled(bool bEnabled);
+
+	void PlayStopEffects() const;
+
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+	friend class UProjectilePoolSubsystem;
 };
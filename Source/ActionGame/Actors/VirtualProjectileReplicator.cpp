@@ -0,0 +1,204 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VirtualProjectileReplicator.h"
+#include "Net/UnrealNetwork.h"
+#include "GameFramework/GameStateBase.h"
+#include "Subsystems/ProjectileSimulationSubsystem.h"
+
+// Impacted records stay in the list long enough for every client to receive the impact
+static const float ImpactedRecordLifetime = 1.f;
+
+void FVirtualProjectileRecord::PreReplicatedRemove(const FVirtualProjectileList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleRecordRemoved(*this);
+	}
+}
+
+void FVirtualProjectileRecord::PostReplicatedAdd(const FVirtualProjectileList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleRecordAdded(*this);
+	}
+}
+
+void FVirtualProjectileRecord::PostReplicatedChange(const FVirtualProjectileList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleRecordChanged(*this);
+	}
+}
+
+AVirtualProjectileReplicator::AVirtualProjectileReplicator()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = true;
+	bAlwaysRelevant = true;
+	SetReplicateMovement(false);
+
+	VirtualProjectiles.Owner = this;
+}
+
+void AVirtualProjectileReplicator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
+	{
+		ProjectileSimulation->RegisterReplicator(this);
+	}
+}
+
+void AVirtualProjectileReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AVirtualProjectileReplicator, ProjectileDataClasses);
+	DOREPLIFETIME(AVirtualProjectileReplicator, VirtualProjectiles);
+}
+
+void AVirtualProjectileReplicator::OnRep_ProjectileDataClasses()
+{
+	if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
+	{
+		for (const TSubclassOf<UProjectileStaticData>& ProjectileDataClass : ProjectileDataClasses)
+		{
+			ProjectileSimulation->RequestProjectileAssets(ProjectileDataClass);
+		}
+	}
+}
+
+float AVirtualProjectileReplicator::GetServerTime() const
+{
+	UWorld* World = GetWorld();
+	AGameStateBase* GameState = World ? World->GetGameState() : nullptr;
+
+	return GameState ? GameState->GetServerWorldTimeSeconds() : (World ? World->GetTimeSeconds() : 0.f);
+}
+
+void AVirtualProjectileReplicator::AddRecord(uint32 ProjectileId, TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FVector& Origin, const FVector& Direction, uint16 Seed)
+{
+	int32 DataIndex = ProjectileDataClasses.Find(ProjectileDataClass);
+
+	if (DataIndex == INDEX_NONE)
+	{
+		if (!ensureMsgf(ProjectileDataClasses.Num() <= MAX_uint8, TEXT("Too many virtual projectile data classes"))) return;
+
+		DataIndex = ProjectileDataClasses.Add(ProjectileDataClass);
+	}
+
+	const int32 Index = VirtualProjectiles.Records.AddDefaulted();
+
+	FVirtualProjectileRecord& Record = VirtualProjectiles.Records[Index];
+	Record.ProjectileDataIndex = static_cast<uint8>(DataIndex);
+	Record.Origin = Origin;
+	Record.Direction = Direction;
+	Record.ServerSpawnTime = GetServerTime();
+	Record.Seed = Seed;
+	Record.ProjectileId = ProjectileId;
+
+	VirtualProjectiles.MarkItemDirty(Record);
+
+	RecordIndexById.Add(ProjectileId, Index);
+}
+
+void AVirtualProjectileReplicator::OnProjectileImpact(uint32 ProjectileId, const FVector& ImpactLocation)
+{
+	if (const int32* Index = RecordIndexById.Find(ProjectileId))
+	{
+		FVirtualProjectileRecord& Record = VirtualProjectiles.Records[*Index];
+		Record.bImpacted = true;
+		Record.ImpactLocation = ImpactLocation;
+		Record.RemoveTime = GetWorld()->GetTimeSeconds() + ImpactedRecordLifetime;
+
+		VirtualProjectiles.MarkItemDirty(Record);
+	}
+}
+
+void AVirtualProjectileReplicator::OnProjectileExpired(uint32 ProjectileId)
+{
+	// Clients run out the same lifetime on their own, nothing else to send
+	if (const int32* Index = RecordIndexById.Find(ProjectileId))
+	{
+		RemoveRecordAt(*Index);
+	}
+}
+
+void AVirtualProjectileReplicator::PruneRecords()
+{
+	const float TimeSeconds = GetWorld()->GetTimeSeconds();
+
+	for (int32 i = VirtualProjectiles.Records.Num() - 1; i >= 0; --i)
+	{
+		const FVirtualProjectileRecord& Record = VirtualProjectiles.Records[i];
+
+		if (Record.bImpacted && Record.RemoveTime <= TimeSeconds)
+		{
+			RemoveRecordAt(i);
+		}
+	}
+}
+
+void AVirtualProjectileReplicator::RemoveRecordAt(int32 Index)
+{
+	TArray<FVirtualProjectileRecord>& Records = VirtualProjectiles.Records;
+	const int32 LastIndex = Records.Num() - 1;
+
+	RecordIndexById.Remove(Records[Index].ProjectileId);
+
+	Records.RemoveAtSwap(Index, 1, false);
+	VirtualProjectiles.MarkArrayDirty();
+
+	if (Index != LastIndex)
+	{
+		RecordIndexById.Add(Records[Index].ProjectileId, Index);
+	}
+}
+
+void AVirtualProjectileReplicator::HandleRecordAdded(FVirtualProjectileRecord& Record)
+{
+	UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>();
+
+	if (!ProjectileSimulation || !ProjectileDataClasses.IsValidIndex(Record.ProjectileDataIndex) || Record.bImpacted) return;
+
+	const float ElapsedTime = FMath::Max(GetServerTime() - Record.ServerSpawnTime, 0.f);
+
+	const uint32 CosmeticId = ProjectileSimulation->LaunchCosmeticProjectile(ProjectileDataClasses[Record.ProjectileDataIndex], Record.Origin, Record.Direction, ElapsedTime, Record.Seed);
+
+	if (CosmeticId != 0)
+	{
+		CosmeticIdByReplicationId.Add(Record.ReplicationID, CosmeticId);
+	}
+}
+
+void AVirtualProjectileReplicator::HandleRecordChanged(FVirtualProjectileRecord& Record)
+{
+	if (!Record.bImpacted) return;
+
+	uint32 CosmeticId = 0;
+
+	if (CosmeticIdByReplicationId.RemoveAndCopyValue(Record.ReplicationID, CosmeticId))
+	{
+		if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
+		{
+			ProjectileSimulation->StopCosmeticProjectile(CosmeticId, Record.ImpactLocation, true);
+		}
+	}
+}
+
+void AVirtualProjectileReplicator::HandleRecordRemoved(FVirtualProjectileRecord& Record)
+{
+	uint32 CosmeticId = 0;
+
+	if (CosmeticIdByReplicationId.RemoveAndCopyValue(Record.ReplicationID, CosmeticId))
+	{
+		if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
+		{
+			ProjectileSimulation->StopCosmeticProjectile(CosmeticId, Record.bImpacted ? FVector(Record.ImpactLocation) : FVector::ZeroVector, Record.bImpacted);
+		}
+	}
+}
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "ActionGameTypes.h"
+#include "VirtualProjectileReplicator.generated.h"
+
+class AVirtualProjectileReplicator;
+
+USTRUCT()
+struct FVirtualProjectileRecord : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	uint8 ProjectileDataIndex = 0;
+
+	UPROPERTY()
+	FVector_NetQuantize Origin;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+
+	UPROPERTY()
+	float ServerSpawnTime = 0.f;
+
+	UPROPERTY()
+	uint16 Seed = 0;
+
+	UPROPERTY()
+	bool bImpacted = false;
+
+	UPROPERTY()
+	FVector_NetQuantize ImpactLocation;
+
+	// Server only
+	UPROPERTY(NotReplicated)
+	uint32 ProjectileId = 0;
+
+	UPROPERTY(NotReplicated)
+	float RemoveTime = 0.f;
+
+	void PreReplicatedRemove(const struct FVirtualProjectileList& InArraySerializer);
+	void PostReplicatedAdd(const struct FVirtualProjectileList& InArraySerializer);
+	void PostReplicatedChange(const struct FVirtualProjectileList& InArraySerializer);
+};
+
+USTRUCT()
+struct FVirtualProjectileList : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FVirtualProjectileRecord, FVirtualProjectileList>(Records, DeltaParams, *this);
+	}
+
+	UPROPERTY()
+	TArray<FVirtualProjectileRecord> Records;
+
+	UPROPERTY(NotReplicated)
+	TObjectPtr<AVirtualProjectileReplicator> Owner = nullptr;
+};
+
+template<>
+struct TStructOpsTypeTraits<FVirtualProjectileList> : public TStructOpsTypeTraitsBase2<FVirtualProjectileList>
+{
+	enum { WithNetDeltaSerializer = true };
+};
+
+/**
+ * Replicates actorless projectiles as compact spawn records instead of one actor channel per projectile.
+ * Clients simulate the ballistic path locally and only receive the authoritative impact.
+ */
+UCLASS(NotPlaceable)
+class ACTIONGAME_API AVirtualProjectileReplicator : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AVirtualProjectileReplicator();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	void AddRecord(uint32 ProjectileId, TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FVector& Origin, const FVector& Direction, uint16 Seed);
+
+	void OnProjectileImpact(uint32 ProjectileId, const FVector& ImpactLocation);
+
+	void OnProjectileExpired(uint32 ProjectileId);
+
+	void PruneRecords();
+
+	bool HasPendingRecords() const { return VirtualProjectiles.Records.Num() > 0; }
+
+	float GetServerTime() const;
+
+protected:
+	virtual void BeginPlay() override;
+
+	UPROPERTY(ReplicatedUsing = OnRep_ProjectileDataClasses)
+	TArray<TSubclassOf<UProjectileStaticData>> ProjectileDataClasses;
+
+	UFUNCTION()
+	void OnRep_ProjectileDataClasses();
+
+	UPROPERTY(Replicated)
+	FVirtualProjectileList VirtualProjectiles;
+
+	void RemoveRecordAt(int32 Index);
+
+	void HandleRecordAdded(FVirtualProjectileRecord& Record);
+
+	void HandleRecordChanged(FVirtualProjectileRecord& Record);
+
+	void HandleRecordRemoved(FVirtualProjectileRecord& Record);
+
+	// Server: projectile id to record index
+	TMap<uint32, int32> RecordIndexById;
+
+	// Client: record replication id to local cosmetic projectile id
+	TMap<int32, uint32> CosmeticIdByReplicationId;
+
+	friend struct FVirtualProjectileRecord;
+};
@@ -0,0 +1,214 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WorldItemManager.h"
+#include "ActionGame.h"
+#include "ActionGameStatics.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Engine/StaticMesh.h"
+#include "Net/UnrealNetwork.h"
+
+FTransform FWorldItemEntry::GetTransform() const
+{
+	return FTransform(FRotator(0.f, FRotator::DecompressAxisFromShort(Yaw), 0.f), Location);
+}
+
+void FWorldItemEntry::PreReplicatedRemove(const FWorldItemList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->RemoveMeshInstance(*this);
+	}
+}
+
+void FWorldItemEntry::PostReplicatedAdd(const FWorldItemList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->AddMeshInstance(*this);
+	}
+}
+
+void FWorldItemEntry::PostReplicatedChange(const FWorldItemList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->UpdateMeshInstance(*this);
+	}
+}
+
+AWorldItemManager::AWorldItemManager()
+{
+	PrimaryActorTick.bCanEverTick = false;
+	bReplicates = true;
+	bAlwaysRelevant = true;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	Items.Owner = this;
+}
+
+void AWorldItemManager::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AWorldItemManager, Items);
+}
+
+void AWorldItemManager::AddRecord(int32 RecordId, TSubclassOf<UItemStaticData> InItemStaticDataClass, const FTransform& Transform)
+{
+	if (SlotByRecordId.Contains(RecordId)) return;
+
+	const int32 Slot = Items.Entries.AddDefaulted();
+
+	FWorldItemEntry& Entry = Items.Entries[Slot];
+	Entry.RecordId = RecordId;
+	Entry.ItemStaticDataClass = InItemStaticDataClass;
+	Entry.Location = Transform.GetLocation();
+	Entry.Yaw = FRotator::CompressAxisToShort(Transform.Rotator().Yaw);
+	Items.MarkItemDirty(Entry);
+
+	SlotByRecordId.Add(RecordId, Slot);
+
+	// Clients draw from the entry callbacks, a listen server draws its own records here
+	AddMeshInstance(Entry);
+}
+
+void AWorldItemManager::RemoveRecord(int32 RecordId)
+{
+	int32 Slot = INDEX_NONE;
+
+	if (!SlotByRecordId.RemoveAndCopyValue(RecordId, Slot)) return;
+
+	RemoveMeshInstance(Items.Entries[Slot]);
+
+	Items.Entries.RemoveAtSwap(Slot, 1, false);
+	Items.MarkArrayDirty();
+
+	if (Items.Entries.IsValidIndex(Slot))
+	{
+		SlotByRecordId.Add(Items.Entries[Slot].RecordId, Slot);
+	}
+}
+
+void AWorldItemManager::AddMeshInstance(const FWorldItemEntry& Entry)
+{
+	// Dedicated servers have nobody to draw for
+	if (GetNetMode() == NM_DedicatedServer || !Entry.ItemStaticDataClass) return;
+
+	UInstancedStaticMeshComponent* MeshComponent = FindOrAddMeshComponent(Entry.ItemStaticDataClass);
+
+	if (!MeshComponent) return;
+
+	FWorldItemMeshInstances& Instances = MeshInstances.FindOrAdd(Entry.ItemStaticDataClass);
+
+	if (Instances.InstanceByReplicationId.Contains(Entry.ReplicationID)) return;
+
+	const int32 Instance = MeshComponent->AddInstance(Entry.GetTransform(), true);
+
+	Instances.ReplicationIdByInstance.Add(Entry.ReplicationID);
+	Instances.InstanceByReplicationId.Add(Entry.ReplicationID, Instance);
+}
+
+void AWorldItemManager::RemoveMeshInstance(const FWorldItemEntry& Entry)
+{
+	FWorldItemMeshInstances* Instances = MeshInstances.Find(Entry.ItemStaticDataClass);
+	TObjectPtr<UInstancedStaticMeshComponent>* MeshComponent = MeshComponents.Find(Entry.ItemStaticDataClass);
+
+	int32 Instance = INDEX_NONE;
+
+	if (!Instances || !MeshComponent || !Instances->InstanceByReplicationId.RemoveAndCopyValue(Entry.ReplicationID, Instance)) return;
+
+	const int32 LastInstance = Instances->ReplicationIdByInstance.Num() - 1;
+
+	if (Instance != LastInstance)
+	{
+		FTransform LastTransform;
+		(*MeshComponent)->GetInstanceTransform(LastInstance, LastTransform, true);
+		(*MeshComponent)->UpdateInstanceTransform(Instance, LastTransform, true, false, true);
+
+		const int32 MovedReplicationId = Instances->ReplicationIdByInstance[LastInstance];
+
+		Instances->ReplicationIdByInstance[Instance] = MovedReplicationId;
+		Instances->InstanceByReplicationId.Add(MovedReplicationId, Instance);
+	}
+
+	// Removing the last instance shifts nothing
+	(*MeshComponent)->RemoveInstance(LastInstance);
+
+	Instances->ReplicationIdByInstance.Pop(false);
+}
+
+void AWorldItemManager::UpdateMeshInstance(const FWorldItemEntry& Entry)
+{
+	const FWorldItemMeshInstances* Instances = MeshInstances.Find(Entry.ItemStaticDataClass);
+	const int32* Instance = Instances ? Instances->InstanceByReplicationId.Find(Entry.ReplicationID) : nullptr;
+
+	if (!Instance)
+	{
+		AddMeshInstance(Entry);
+		return;
+	}
+
+	MeshComponents.FindChecked(Entry.ItemStaticDataClass)->UpdateInstanceTransform(*Instance, Entry.GetTransform(), true, true, true);
+}
+
+UInstancedStaticMeshComponent* AWorldItemManager::FindOrAddMeshComponent(TSubclassOf<UItemStaticData> InItemStaticDataClass)
+{
+	if (TObjectPtr<UInstancedStaticMeshComponent>* MeshComponent = MeshComponents.Find(InItemStaticDataClass))
+	{
+		return *MeshComponent;
+	}
+
+	const UItemStaticData* ItemStaticData = UActionGameStatics::GetItemStaticData(InItemStaticDataClass);
+
+	if (!ItemStaticData || ItemStaticData->WorldStaticMesh.IsNull()) return nullptr;
+
+	UStaticMesh* StaticMesh = ItemStaticData->WorldStaticMesh.Get();
+
+	if (!StaticMesh)
+	{
+		// Streamed in the background, the item type is rebuilt once the mesh arrives
+		if (!PendingMeshLoads.Contains(InItemStaticDataClass))
+		{
+			PendingMeshLoads.Add(InItemStaticDataClass, UAssetManager::GetStreamableManager().RequestAsyncLoad(ItemStaticData->WorldStaticMesh.ToSoftObjectPath(), FStreamableDelegate::CreateUObject(this, &AWorldItemManager::OnWorldMeshLoaded, InItemStaticDataClass)));
+		}
+		return nullptr;
+	}
+
+	UInstancedStaticMeshComponent* MeshComponent = NewObject<UInstancedStaticMeshComponent>(this);
+	MeshComponent->SetStaticMesh(StaticMesh);
+	MeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	MeshComponent->SetupAttachment(RootComponent);
+	MeshComponent->RegisterComponent();
+
+	MeshComponents.Add(InItemStaticDataClass, MeshComponent);
+
+	return MeshComponent;
+}
+
+void AWorldItemManager::OnWorldMeshLoaded(TSubclassOf<UItemStaticData> InItemStaticDataClass)
+{
+	const UItemStaticData* ItemStaticData = UActionGameStatics::GetItemStaticData(InItemStaticDataClass);
+
+	// A mesh that failed to load keeps its pending entry, so it is not requested again every rebuild
+	if (!ItemStaticData || !ItemStaticData->WorldStaticMesh.Get())
+	{
+		UE_LOG(LogActionGame, Warning, TEXT("World mesh of %s failed to load, its world items are not drawn"), *GetNameSafe(InItemStaticDataClass));
+		return;
+	}
+
+	// The mesh component keeps the mesh loaded from here on
+	PendingMeshLoads.Remove(InItemStaticDataClass);
+
+	// Entries of this type that arrived while the mesh was streaming were not drawn yet
+	for (const FWorldItemEntry& Entry : Items.Entries)
+	{
+		if (Entry.ItemStaticDataClass == InItemStaticDataClass)
+		{
+			AddMeshInstance(Entry);
+		}
+	}
+}
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ActionGameTypes.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "WorldItemManager.generated.h"
+
+class AWorldItemManager;
+class UInstancedStaticMeshComponent;
+struct FStreamableHandle;
+
+USTRUCT()
+struct FWorldItemEntry : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(NotReplicated)
+	int32 RecordId = 0;
+
+	UPROPERTY()
+	TSubclassOf<UItemStaticData> ItemStaticDataClass;
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	/** World items only turn around the up axis */
+	UPROPERTY()
+	uint16 Yaw = 0;
+
+	FTransform GetTransform() const;
+
+	void PreReplicatedRemove(const struct FWorldItemList& InArraySerializer);
+	void PostReplicatedAdd(const struct FWorldItemList& InArraySerializer);
+	void PostReplicatedChange(const struct FWorldItemList& InArraySerializer);
+};
+
+USTRUCT()
+struct FWorldItemList : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FWorldItemEntry, FWorldItemList>(Entries, DeltaParams, *this);
+	}
+
+	UPROPERTY()
+	TArray<FWorldItemEntry> Entries;
+
+	UPROPERTY(NotReplicated)
+	TObjectPtr<AWorldItemManager> Owner = nullptr;
+};
+
+template<>
+struct TStructOpsTypeTraits<FWorldItemList> : public TStructOpsTypeTraitsBase2<FWorldItemList>
+{
+	enum { WithNetDeltaSerializer = true };
+};
+
+/** Which entry each instance of an item type's mesh draws, so one entry is added or removed without touching the rest */
+struct FWorldItemMeshInstances
+{
+	TArray<int32> ReplicationIdByInstance;
+
+	TMap<int32, int32> InstanceByReplicationId;
+};
+
+/**
+ * Replicates the world item records of the level in one fast array and draws them as one instanced mesh per item type.
+ * Spawned by the world item subsystem on the server, records come and go as items are promoted to item actors and demoted again.
+ */
+UCLASS(NotPlaceable)
+class ACTIONGAME_API AWorldItemManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AWorldItemManager();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	void AddRecord(int32 RecordId, TSubclassOf<UItemStaticData> InItemStaticDataClass, const FTransform& Transform);
+
+	void RemoveRecord(int32 RecordId);
+
+protected:
+	UPROPERTY(Replicated)
+	FWorldItemList Items;
+
+	/** Server side slot of every record in Items */
+	TMap<int32, int32> SlotByRecordId;
+
+	UPROPERTY(Transient)
+	TMap<TSubclassOf<UItemStaticData>, TObjectPtr<UInstancedStaticMeshComponent>> MeshComponents;
+
+	TMap<TSubclassOf<UItemStaticData>, FWorldItemMeshInstances> MeshInstances;
+
+	/** World meshes still streaming in, their item types are drawn once the mesh arrives */
+	TMap<TSubclassOf<UItemStaticData>, TSharedPtr<FStreamableHandle>> PendingMeshLoads;
+
+	/** Draws the entry, entries whose mesh is still streaming are drawn with the rest of their type once it arrives */
+	void AddMeshInstance(const FWorldItemEntry& Entry);
+
+	/** Moves the last instance of the type into the removed one's place, so only those two change */
+	void RemoveMeshInstance(const FWorldItemEntry& Entry);
+
+	void UpdateMeshInstance(const FWorldItemEntry& Entry);
+
+	UInstancedStaticMeshComponent* FindOrAddMeshComponent(TSubclassOf<UItemStaticData> InItemStaticDataClass);
+
+	void OnWorldMeshLoaded(TSubclassOf<UItemStaticData> InItemStaticDataClass);
+
+	friend struct FWorldItemEntry;
+};
@@ -12,13 +12,28 @@
 #include "ActorComponents/InventoryComponent.h"
 #include "Inventory/InventoryItemInstance.h"
 
-const UItemStaticData* UAG_AnimInstance::GetEquippedItemData() const
+void UAG_AnimInstance::NativeInitializeAnimation()
 {
+	Super::NativeInitializeAnimation();
+
 	AActionGameCharacter* ActionGameCharacter = Cast<AActionGameCharacter>(GetOwningActor());
-	UInventoryComponent* InventoryComponent = ActionGameCharacter ? ActionGameCharacter->GetInventoryComponent() : nullptr;
-	UInventoryItemInstance* ItemInstance = InventoryComponent ? InventoryComponent->GetEquippedItem() : nullptr;
 
-	return ItemInstance ? ItemInstance->GetItemStaticData() : nullptr;
+	if (UInventoryComponent* InventoryComponent = ActionGameCharacter ? ActionGameCharacter->GetInventoryComponent() : nullptr)
+	{
+		InventoryComponent->OnEquippedItemChanged.AddUniqueDynamic(this, &UAG_AnimInstance::OnEquippedItemChanged);
+
+		OnEquippedItemChanged(nullptr, InventoryComponent->GetEquippedItem());
+	}
+}
+
+void UAG_AnimInstance::OnEquippedItemChanged(UInventoryItemInstance* OldItem, UInventoryItemInstance* NewItem)
+{
+	EquippedItemData = NewItem ? NewItem->GetItemStaticData() : nullptr;
+}
+
+const UItemStaticData* UAG_AnimInstance::GetEquippedItemData() const
+{
+	return EquippedItemData;
 }
 
 UBlendSpace* UAG_AnimInstance::GetLocomotionBlendspace() const
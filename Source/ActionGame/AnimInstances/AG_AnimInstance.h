@@ -7,6 +7,7 @@
 #include "AG_AnimInstance.generated.h"
 
 class UItemStaticData;
+class UInventoryItemInstance;
 
 UCLASS()
 class ACTIONGAME_API UAG_AnimInstance : public UAnimInstance
@@ -15,6 +16,14 @@ class ACTIONGAME_API UAG_AnimInstance : public UAnimInstance
 	
 protected:
 
+	virtual void NativeInitializeAnimation() override;
+
+	UFUNCTION()
+	void OnEquippedItemChanged(UInventoryItemInstance* OldItem, UInventoryItemInstance* NewItem);
+
+	/** Refreshed when the inventory reports an equip change instead of looked up on every evaluation */
+	const UItemStaticData* EquippedItemData = nullptr;
+
 	const UItemStaticData* GetEquippedItemData() const;
 
 	UFUNCTION(BlueprintCallable, meta = (BlueprintThreadSafe))
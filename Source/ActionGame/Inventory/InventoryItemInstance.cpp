@@ -11,12 +11,27 @@
 #include "AbilitySystemBlueprintLibrary.h"
 #include "GameFramework/Character.h"
 #include "AbilitySystemLog.h"
+#include "Engine/StreamableManager.h"
 
 void UInventoryItemInstance::Init(TSubclassOf<UItemStaticData> InItemStaticDataClass)
 {
 	ItemStaticDataClass = InItemStaticDataClass;
 }
 
+void UInventoryItemInstance::RequestAssets()
+{
+	if (!AssetsHandle.IsValid())
+	{
+		AssetsHandle = UActionGameStatics::RequestStaticDataAssets(ItemStaticDataClass);
+	}
+}
+
+void UInventoryItemInstance::OnRep_ItemStaticDataClass()
+{
+	// Clients only receive instances in their own inventory or on a pickup relevant to them
+	RequestAssets();
+}
+
 const UItemStaticData* UInventoryItemInstance::GetItemStaticData() const
 {
 	return UActionGameStatics::GetItemStaticData(ItemStaticDataClass);
@@ -38,21 +53,27 @@ void UInventoryItemInstance::GetLifetimeReplicatedProps(TArray<FLifetimeProperty
 
 void UInventoryItemInstance::OnEquipped(AActor* InOwner)
 {
-	if (UWorld* World = InOwner->GetWorld())
+	if (!IsValid(ItemActor))
 	{
-		const UItemStaticData* StaticData = GetItemStaticData();
-		FTransform Transform;
-		ItemActor = World->SpawnActorDeferred<AItemActor>(StaticData->ItemActorClass, Transform, InOwner);
-		ItemActor->Init(this);
-		ItemActor->OnEquipped();
-		ItemActor->FinishSpawning(Transform);
-
-		ACharacter* Character = Cast<ACharacter>(InOwner);
-		if (USkeletalMeshComponent* SkeletalMesh = Character ? Character->GetMesh() : nullptr)
+		if (UWorld* World = InOwner->GetWorld())
 		{
-			ItemActor->AttachToComponent(SkeletalMesh, FAttachmentTransformRules::SnapToTargetNotIncludingScale, StaticData->AttachmentSocket);
+			const UItemStaticData* StaticData = GetItemStaticData();
+			FTransform Transform;
+			ItemActor = World->SpawnActorDeferred<AItemActor>(StaticData->ItemActorClass, Transform, InOwner);
+			ItemActor->Init(this);
+			// Disables the pickup sphere before the actor is registered, so it never overlaps its own owner
+			ItemActor->OnEquipped();
+			ItemActor->FinishSpawning(Transform);
+
+			AttachItemActor(InOwner);
 		}
 	}
+	else
+	{
+		AttachItemActor(InOwner);
+
+		ItemActor->OnEquipped();
+	}
 
 	TryGrantAbilities(InOwner);
 	TryApplyEffects(InOwner);
@@ -64,8 +85,7 @@ void UInventoryItemInstance::OnUnequipped(AActor* InOwner)
 {
 	if (ItemActor)
 	{
-		ItemActor->Destroy();
-		ItemActor = nullptr;
+		ItemActor->OnUnequipped();
 	}
 
 	TryRemoveAbilities(InOwner);
@@ -87,6 +107,44 @@ void UInventoryItemInstance::OnDropped(AActor* InOwner)
 	bEquipped = false;
 }
 
+void UInventoryItemInstance::OnPickedUp(AActor* InOwner, AItemActor* InItemActor)
+{
+	if (IsValid(ItemActor) && ItemActor != InItemActor)
+	{
+		ItemActor->Destroy();
+	}
+
+	ItemActor = InItemActor;
+
+	if (ItemActor)
+	{
+		ItemActor->SetOwner(InOwner);
+
+		AttachItemActor(InOwner);
+
+		ItemActor->OnUnequipped();
+	}
+}
+
+void UInventoryItemInstance::DestroyItemActor()
+{
+	if (IsValid(ItemActor) && !ItemActor->IsDropped())
+	{
+		ItemActor->Destroy();
+	}
+
+	ItemActor = nullptr;
+}
+
+void UInventoryItemInstance::AttachItemActor(AActor* InOwner)
+{
+	ACharacter* Character = Cast<ACharacter>(InOwner);
+	if (USkeletalMeshComponent* SkeletalMesh = Character ? Character->GetMesh() : nullptr)
+	{
+		ItemActor->AttachToComponent(SkeletalMesh, FAttachmentTransformRules::SnapToTargetNotIncludingScale, GetItemStaticData()->AttachmentSocket);
+	}
+}
+
 AItemActor* UInventoryItemInstance::GetItemActor() const
 {
 	return ItemActor;
@@ -7,6 +7,8 @@
 #include "GameplayAbilitySpec.h"
 #include "InventoryItemInstance.generated.h"
 
+struct FStreamableHandle;
+
 /**
  * 
  */
@@ -18,14 +20,20 @@ class ACTIONGAME_API UInventoryItemInstance : public UObject
 public:
 	virtual void Init(TSubclassOf<class UItemStaticData> InItemStaticDataClass);
 
+	/** Starts streaming the item's content, called once the item is in an inventory */
+	void RequestAssets();
+
 	virtual bool IsSupportedForNetworking() const override { return true; }
 
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	const UItemStaticData* GetItemStaticData() const;
 	
-	UPROPERTY(Replicated)
+	UPROPERTY(ReplicatedUsing = OnRep_ItemStaticDataClass)
 	TSubclassOf<UItemStaticData> ItemStaticDataClass;
 
+	UFUNCTION()
+	void OnRep_ItemStaticDataClass();
+
 	UPROPERTY(ReplicatedUsing = OnRep_Equipped)
 	bool bEquipped = false;
 
@@ -38,13 +46,22 @@ public:
 	virtual void OnUnequipped(AActor* InOwner = nullptr);
 	virtual void OnDropped(AActor* InOwner = nullptr);
 
+	/** Takes a dropped item actor back into the owner's inventory, hidden until equipped */
+	virtual void OnPickedUp(AActor* InOwner, AItemActor* InItemActor);
+
+	/** Destroys the item actor unless it was dropped into the world */
+	void DestroyItemActor();
+
 	UFUNCTION(BlueprintPure)
 	AItemActor* GetItemActor() const;
 
 protected:
+	/** Kept for as long as the item is in an inventory, equipping only attaches and shows it */
 	UPROPERTY(Replicated)
 	class AItemActor* ItemActor = nullptr;
 
+	void AttachItemActor(AActor* InOwner);
+
 	void TryGrantAbilities(AActor* InOwner);
 
 	void TryRemoveAbilities(AActor* InOwner);
@@ -59,4 +76,7 @@ protected:
 	UPROPERTY()
 	TArray<FActiveGameplayEffectHandle> OngoingEffectHandles;
 
+	/** Keeps the item's soft referenced content loaded while it is in an inventory */
+	TSharedPtr<FStreamableHandle> AssetsHandle;
+
 };
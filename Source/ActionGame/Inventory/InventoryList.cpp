@@ -3,32 +3,515 @@
 
 #include "InventoryList.h"
 #include "InventoryItemInstance.h"
+#include "ActorComponents/InventoryComponent.h"
+#include "ActionGameStatics.h"
 
-void FInventoryList::AddItem(TSubclassOf<class UItemStaticData> InItemStaticDataClass)
+bool FInventoryListItem::IsStack() const
 {
-	FInventoryListItem& Item = Items.AddDefaulted_GetRef();
-	Item.ItemInstance = NewObject<UInventoryItemInstance>();
-	Item.ItemInstance->Init(InItemStaticDataClass);
-	MarkItemDirty(Item);
+	const UItemStaticData* ItemStaticData = UActionGameStatics::GetItemStaticData(ItemStaticDataClass);
+
+	return ItemStaticData && !ItemStaticData->RequiresInstance();
+}
+
+void FInventoryListItem::PreReplicatedRemove(const FInventoryList& InArraySerializer)
+{
+	UInventoryComponent* OwnerComponent = InArraySerializer.OwnerComponent;
+
+	if (IsStack())
+	{
+		const_cast<FInventoryList&>(InArraySerializer).AdjustStackCount(ItemStaticDataClass, -ReceivedStackCount);
+		ReceivedStackCount = 0;
+
+		// The count is broadcast once the whole update is applied
+		InArraySerializer.DirtyStackClasses.Add(ItemStaticDataClass);
+	}
+	else if (ReceivedItemInstance)
+	{
+		const_cast<FInventoryList&>(InArraySerializer).UnindexInstance(ReceivedItemInstance);
+
+		if (OwnerComponent)
+		{
+			OwnerComponent->HandleItemRemoved(ReceivedItemInstance);
+		}
+	}
+	ReceivedItemInstance = nullptr;
+}
+
+void FInventoryListItem::PostReplicatedAdd(const FInventoryList& InArraySerializer)
+{
+	HandleReplicated(InArraySerializer);
+}
+
+void FInventoryListItem::PostReplicatedChange(const FInventoryList& InArraySerializer)
+{
+	HandleReplicated(InArraySerializer);
+}
+
+void FInventoryListItem::HandleReplicated(const FInventoryList& InArraySerializer)
+{
+	UInventoryComponent* OwnerComponent = InArraySerializer.OwnerComponent;
+
+	FInventoryList& List = const_cast<FInventoryList&>(InArraySerializer);
+
+	if (IsStack())
+	{
+		List.AdjustStackCount(ItemStaticDataClass, StackCount - ReceivedStackCount);
+		ReceivedStackCount = StackCount;
+
+		InArraySerializer.DirtyStackClasses.Add(ItemStaticDataClass);
+		return;
+	}
+
+	if (ReceivedItemInstance == ItemInstance)
+	{
+		if (ItemInstance && OwnerComponent)
+		{
+			OwnerComponent->HandleItemChanged(ItemInstance);
+		}
+		return;
+	}
+
+	// The entry now points at a different instance, or its instance just resolved
+	if (ReceivedItemInstance)
+	{
+		List.UnindexInstance(ReceivedItemInstance);
+
+		if (OwnerComponent)
+		{
+			OwnerComponent->HandleItemRemoved(ReceivedItemInstance);
+		}
+	}
+
+	ReceivedItemInstance = ItemInstance;
+
+	if (ItemInstance)
+	{
+		List.IndexInstance(ItemInstance);
+
+		if (OwnerComponent)
+		{
+			OwnerComponent->HandleItemAdded(ItemInstance);
+		}
+	}
+}
+
+void FInventoryList::PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters)
+{
+	// One update can add, change and remove several stacks of a class, so each class is broadcast once with its final count
+	TSet<TSubclassOf<UItemStaticData>> StackClasses = MoveTemp(DirtyStackClasses);
+	DirtyStackClasses.Reset();
+
+	if (!OwnerComponent) return;
+
+	for (const TSubclassOf<UItemStaticData>& StackClass : StackClasses)
+	{
+		OwnerComponent->HandleStackChanged(StackClass, GetStackCount(StackClass));
+	}
+}
+
+UInventoryItemInstance* FInventoryList::AddItem(TSubclassOf<class UItemStaticData> InItemStaticDataClass)
+{
+	const UItemStaticData* ItemStaticData = UActionGameStatics::GetItemStaticData(InItemStaticDataClass);
+
+	if (!ItemStaticData) return nullptr;
+
+	if (!ItemStaticData->RequiresInstance())
+	{
+		AddStack(InItemStaticDataClass, 1);
+		return nullptr;
+	}
+
+	UInventoryItemInstance* ItemInstance = NewObject<UInventoryItemInstance>();
+	ItemInstance->Init(InItemStaticDataClass);
+
+	return AddItem(ItemInstance) ? ItemInstance : nullptr;
 }
 
-void FInventoryList::AddItem(UInventoryItemInstance* InItemInstance)
+bool FInventoryList::AddItem(UInventoryItemInstance* InItemInstance)
 {
-	FInventoryListItem& Item = Items.AddDefaulted_GetRef();
+	if (!InItemInstance || Contains(InItemInstance)) return false;
+
+	const int32 Slot = Items.AddDefaulted();
+
+	FInventoryListItem& Item = Items[Slot];
 	Item.ItemInstance = InItemInstance;
+	Item.ItemStaticDataClass = InItemInstance->ItemStaticDataClass;
 	MarkItemDirty(Item);
+
+	IndexItem(Slot);
+
+	return true;
 }
 
-void FInventoryList::RemoveItem(TSubclassOf<class UItemStaticData> InItemStaticDataClass)
+UInventoryItemInstance* FInventoryList::AddSnapshotItem(const FInventoryItemSnapshot& InItem)
 {
-	for (auto ItemIter = Items.CreateIterator(); ItemIter; ++ItemIter)
+	const UItemStaticData* ItemStaticData = UActionGameStatics::GetItemStaticData(InItem.ItemStaticDataClass);
+
+	if (!ItemStaticData) return nullptr;
+
+	if (ItemStaticData->RequiresInstance())
+	{
+		UInventoryItemInstance* ItemInstance = AddItem(InItem.ItemStaticDataClass);
+
+		if (ItemInstance)
+		{
+			FInventoryListItem& Item = Items[GetSlot(ItemInstance)];
+			Item.StateFlags = InItem.StateFlags;
+			MarkItemDirty(Item);
+		}
+		return ItemInstance;
+	}
+
+	if (InItem.StackCount > 0)
 	{
-		FInventoryListItem& Item = *ItemIter;
-		if (Item.ItemInstance && Item.ItemInstance->GetItemStaticData()->IsA(InItemStaticDataClass))
+		const int32 Slot = Items.AddDefaulted();
+
+		FInventoryListItem& Item = Items[Slot];
+		Item.ItemStaticDataClass = InItem.ItemStaticDataClass;
+		Item.StackCount = InItem.StackCount;
+		Item.StateFlags = InItem.StateFlags;
+		MarkItemDirty(Item);
+
+		IndexItem(Slot);
+	}
+	return nullptr;
+}
+
+void FInventoryList::Empty()
+{
+	// Handles given out before are released rather than forgotten, so they cannot resolve to later entries
+	for (const FInventoryListItem& Item : Items)
+	{
+		ReleaseSlotHandle(Item.HandleIndex);
+	}
+
+	Items.Empty();
+	MarkArrayDirty();
+
+	HandleByInstance.Empty();
+	ItemsByClass.Empty();
+	EquippableItems.Empty();
+	EquippableIndexByInstance.Empty();
+	StackHandlesByClass.Empty();
+	StackCountByClass.Empty();
+}
+
+UInventoryItemInstance* FInventoryList::RemoveItem(TSubclassOf<class UItemStaticData> InItemStaticDataClass)
+{
+	UInventoryItemInstance* ItemInstance = FindItem(InItemStaticDataClass);
+
+	// Removal by class also takes derived items, the first one in the inventory goes
+	if (!ItemInstance && InItemStaticDataClass)
+	{
+		int32 FirstSlot = Items.Num();
+
+		for (const auto& ClassItems : ItemsByClass)
+		{
+			if (!ClassItems.Key->IsChildOf(InItemStaticDataClass) || ClassItems.Value.Num() == 0) continue;
+
+			const int32 Slot = GetSlot(ClassItems.Value[0]);
+
+			if (Slot != INDEX_NONE && Slot < FirstSlot)
+			{
+				FirstSlot = Slot;
+				ItemInstance = ClassItems.Value[0];
+			}
+		}
+	}
+
+	return RemoveItem(ItemInstance) ? ItemInstance : nullptr;
+}
+
+bool FInventoryList::RemoveItem(UInventoryItemInstance* InItemInstance)
+{
+	const int32 Slot = GetSlot(InItemInstance);
+
+	if (Slot == INDEX_NONE) return false;
+
+	RemoveSlot(Slot);
+
+	return true;
+}
+
+void FInventoryList::AddStack(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 Count)
+{
+	const UItemStaticData* ItemStaticData = UActionGameStatics::GetItemStaticData(InItemStaticDataClass);
+
+	if (!ItemStaticData || ItemStaticData->RequiresInstance() || Count <= 0) return;
+
+	const int32 MaxStackSize = FMath::Clamp(ItemStaticData->MaxStackSize, 1, (int32)MAX_uint16);
+
+	if (const TArray<int32, TInlineAllocator<2>>* StackHandles = StackHandlesByClass.Find(InItemStaticDataClass))
+	{
+		for (const int32 HandleIndex : *StackHandles)
+		{
+			if (Count == 0) break;
+
+			FInventoryListItem& Item = Items[SlotHandles[HandleIndex].Slot];
+
+			if (Item.StackCount >= MaxStackSize) continue;
+
+			const int32 Added = FMath::Min(Count, MaxStackSize - Item.StackCount);
+
+			Item.StackCount = (uint16)(Item.StackCount + Added);
+			Count -= Added;
+
+			AdjustStackCount(InItemStaticDataClass, Added);
+
+			MarkItemDirty(Item);
+		}
+	}
+
+	while (Count > 0)
+	{
+		const int32 Slot = Items.AddDefaulted();
+
+		FInventoryListItem& Item = Items[Slot];
+		Item.ItemStaticDataClass = InItemStaticDataClass;
+		Item.StackCount = (uint16)FMath::Min(Count, MaxStackSize);
+
+		Count -= Item.StackCount;
+
+		MarkItemDirty(Item);
+
+		IndexItem(Slot);
+	}
+}
+
+int32 FInventoryList::RemoveStack(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 Count)
+{
+	int32 Removed = 0;
+
+	while (Removed < Count)
+	{
+		// Emptying a stack removes its slot, so the newest stack is looked up again each time
+		const TArray<int32, TInlineAllocator<2>>* StackHandles = StackHandlesByClass.Find(InItemStaticDataClass);
+
+		if (!StackHandles) break;
+
+		const int32 Slot = SlotHandles[StackHandles->Last()].Slot;
+
+		FInventoryListItem& Item = Items[Slot];
+
+		const int32 Taken = FMath::Min<int32>(Count - Removed, Item.StackCount);
+
+		Item.StackCount = (uint16)(Item.StackCount - Taken);
+		Removed += Taken;
+
+		AdjustStackCount(InItemStaticDataClass, -Taken);
+
+		if (Item.StackCount == 0)
+		{
+			RemoveSlot(Slot);
+		}
+		else
+		{
+			MarkItemDirty(Item);
+		}
+	}
+
+	return Removed;
+}
+
+int32 FInventoryList::GetStackCount(TSubclassOf<UItemStaticData> InItemStaticDataClass) const
+{
+	const int32* Count = StackCountByClass.Find(InItemStaticDataClass);
+
+	return Count ? *Count : 0;
+}
+
+void FInventoryList::RemoveSlot(int32 Slot)
+{
+	UnindexItem(Slot);
+
+	// Keeps the inventory in the order items were picked up, the later entries move down one slot
+	Items.RemoveAt(Slot, 1, false);
+	MarkArrayDirty();
+
+	// Lookups hold handles, so only the handle table needs the new slots
+	for (int32 MovedSlot = Slot; MovedSlot < Items.Num(); ++MovedSlot)
+	{
+		const int32 HandleIndex = Items[MovedSlot].HandleIndex;
+
+		if (SlotHandles.IsValidIndex(HandleIndex))
+		{
+			SlotHandles[HandleIndex].Slot = MovedSlot;
+		}
+	}
+}
+
+UInventoryItemInstance* FInventoryList::FindItem(TSubclassOf<UItemStaticData> InItemStaticDataClass) const
+{
+	const TArray<UInventoryItemInstance*, TInlineAllocator<2>>* ClassItems = ItemsByClass.Find(InItemStaticDataClass);
+
+	return ClassItems && ClassItems->Num() > 0 ? (*ClassItems)[0] : nullptr;
+}
+
+FInventorySlotHandle FInventoryList::GetSlotHandle(const UInventoryItemInstance* InItemInstance) const
+{
+	FInventorySlotHandle Handle;
+
+	if (const int32* HandleIndex = HandleByInstance.Find(InItemInstance))
+	{
+		Handle.Index = *HandleIndex;
+		Handle.Generation = SlotHandles[*HandleIndex].Generation;
+	}
+	return Handle;
+}
+
+const FInventoryListItem* FInventoryList::ResolveSlotHandle(const FInventorySlotHandle& Handle) const
+{
+	if (!SlotHandles.IsValidIndex(Handle.Index)) return nullptr;
+
+	const FSlotHandleEntry& Entry = SlotHandles[Handle.Index];
+
+	if (Entry.Generation != Handle.Generation || !Items.IsValidIndex(Entry.Slot)) return nullptr;
+
+	return &Items[Entry.Slot];
+}
+
+bool FInventoryList::Contains(const UInventoryItemInstance* InItemInstance) const
+{
+	if (!InItemInstance) return false;
+
+	const TArray<UInventoryItemInstance*, TInlineAllocator<2>>* ClassItems = ItemsByClass.Find(InItemInstance->ItemStaticDataClass);
+
+	return ClassItems && ClassItems->Contains(InItemInstance);
+}
+
+UInventoryItemInstance* FInventoryList::FindNextEquippable(const UInventoryItemInstance* InItemInstance) const
+{
+	if (EquippableItems.Num() == 0) return nullptr;
+
+	const int32* Index = EquippableIndexByInstance.Find(InItemInstance);
+
+	return EquippableItems[Index ? (*Index + 1) % EquippableItems.Num() : 0];
+}
+
+void FInventoryList::IndexItem(int32 Slot)
+{
+	const FInventoryListItem& Item = Items[Slot];
+
+	const int32 HandleIndex = AcquireSlotHandle(Slot);
+
+	// The server only keeps entries without an instance for stacks
+	if (!Item.ItemInstance)
+	{
+		StackHandlesByClass.FindOrAdd(Item.ItemStaticDataClass).Add(HandleIndex);
+		AdjustStackCount(Item.ItemStaticDataClass, Item.StackCount);
+		return;
+	}
+
+	HandleByInstance.Add(Item.ItemInstance, HandleIndex);
+
+	IndexInstance(Item.ItemInstance);
+}
+
+void FInventoryList::UnindexItem(int32 Slot)
+{
+	FInventoryListItem& Item = Items[Slot];
+
+	const int32 HandleIndex = Item.HandleIndex;
+
+	ReleaseSlotHandle(HandleIndex);
+	Item.HandleIndex = INDEX_NONE;
+
+	if (!Item.ItemInstance)
+	{
+		if (TArray<int32, TInlineAllocator<2>>* StackHandles = StackHandlesByClass.Find(Item.ItemStaticDataClass))
+		{
+			StackHandles->RemoveSingle(HandleIndex);
+
+			if (StackHandles->Num() == 0)
+			{
+				StackHandlesByClass.Remove(Item.ItemStaticDataClass);
+			}
+		}
+		AdjustStackCount(Item.ItemStaticDataClass, -Item.StackCount);
+		return;
+	}
+
+	HandleByInstance.Remove(Item.ItemInstance);
+
+	UnindexInstance(Item.ItemInstance);
+}
+
+int32 FInventoryList::AcquireSlotHandle(int32 Slot)
+{
+	const int32 HandleIndex = FreeSlotHandles.Num() > 0 ? FreeSlotHandles.Pop(false) : SlotHandles.AddDefaulted();
+
+	SlotHandles[HandleIndex].Slot = Slot;
+	Items[Slot].HandleIndex = HandleIndex;
+
+	return HandleIndex;
+}
+
+void FInventoryList::ReleaseSlotHandle(int32 HandleIndex)
+{
+	if (!SlotHandles.IsValidIndex(HandleIndex)) return;
+
+	FSlotHandleEntry& Entry = SlotHandles[HandleIndex];
+	Entry.Slot = INDEX_NONE;
+	++Entry.Generation;
+
+	FreeSlotHandles.Add(HandleIndex);
+}
+
+int32 FInventoryList::GetSlot(const UInventoryItemInstance* InItemInstance) const
+{
+	const int32* HandleIndex = HandleByInstance.Find(InItemInstance);
+
+	return HandleIndex ? SlotHandles[*HandleIndex].Slot : INDEX_NONE;
+}
+
+void FInventoryList::AdjustStackCount(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 Delta)
+{
+	if (Delta == 0) return;
+
+	int32& Count = StackCountByClass.FindOrAdd(InItemStaticDataClass);
+	Count += Delta;
+
+	if (Count <= 0)
+	{
+		StackCountByClass.Remove(InItemStaticDataClass);
+	}
+}
+
+void FInventoryList::IndexInstance(UInventoryItemInstance* InItemInstance)
+{
+	ItemsByClass.FindOrAdd(InItemInstance->ItemStaticDataClass).Add(InItemInstance);
+
+	const UItemStaticData* ItemStaticData = InItemInstance->GetItemStaticData();
+
+	if (ItemStaticData && ItemStaticData->bCanBeEquipped)
+	{
+		EquippableIndexByInstance.Add(InItemInstance, EquippableItems.Add(InItemInstance));
+	}
+}
+
+void FInventoryList::UnindexInstance(UInventoryItemInstance* InItemInstance)
+{
+	if (TArray<UInventoryItemInstance*, TInlineAllocator<2>>* ClassItems = ItemsByClass.Find(InItemInstance->ItemStaticDataClass))
+	{
+		// Keeps the order items were added in, FindItem returns the oldest
+		ClassItems->RemoveSingle(InItemInstance);
+
+		if (ClassItems->Num() == 0)
+		{
+			ItemsByClass.Remove(InItemInstance->ItemStaticDataClass);
+		}
+	}
+
+	int32 EquippableIndex = INDEX_NONE;
+
+	if (EquippableIndexByInstance.RemoveAndCopyValue(InItemInstance, EquippableIndex))
+	{
+		// EquipNext cycles in the order items were picked up, so the later items move down
+		EquippableItems.RemoveAt(EquippableIndex, 1, false);
+
+		for (int32 Index = EquippableIndex; Index < EquippableItems.Num(); ++Index)
 		{
-			ItemIter.RemoveCurrent();
-			MarkArrayDirty();
-			break;
+			EquippableIndexByInstance.Add(EquippableItems[Index], Index);
 		}
 	}
 }
@@ -7,14 +7,74 @@
 #include "InventoryList.generated.h"
 
 class UInventoryItemInstance;
+class UInventoryComponent;
+
+/** Saved form of an inventory entry, instances are recreated from their static data on restore */
+struct FInventoryItemSnapshot
+{
+	TSubclassOf<UItemStaticData> ItemStaticDataClass;
+
+	uint16 StackCount = 1;
+
+	uint8 StateFlags = 0;
+};
+
+struct FInventorySnapshot
+{
+	TArray<FInventoryItemSnapshot> Items;
+
+	/** Index into Items of the equipped item */
+	int32 EquippedIndex = INDEX_NONE;
+};
+
+/** Refers to an inventory entry for as long as it stays in the list, wherever removals move it */
+struct FInventorySlotHandle
+{
+	int32 Index = INDEX_NONE;
+
+	uint32 Generation = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+};
 
 USTRUCT(BlueprintType)
 struct FInventoryListItem : public FFastArraySerializerItem
 {
 	GENERATED_USTRUCT_BODY()
 
+	/** Only set for items that need per instance behaviour, stacked items are described by the entry alone */
 	UPROPERTY()
 	UInventoryItemInstance* ItemInstance = nullptr;
+
+	/** Replicated inline so clients know the item before its instance resolves */
+	UPROPERTY()
+	TSubclassOf<UItemStaticData> ItemStaticDataClass;
+
+	UPROPERTY()
+	uint16 StackCount = 1;
+
+	UPROPERTY()
+	uint8 StateFlags = 0;
+
+	/** Instance last announced to the client, the subobject can resolve after the entry itself arrives */
+	UPROPERTY(NotReplicated)
+	UInventoryItemInstance* ReceivedItemInstance = nullptr;
+
+	/** Stack count last applied to the client's totals, so a change only adds the difference */
+	UPROPERTY(NotReplicated)
+	uint16 ReceivedStackCount = 0;
+
+	/** Server side index into the list's handle table */
+	int32 HandleIndex = INDEX_NONE;
+
+	bool IsStack() const;
+
+	void PreReplicatedRemove(const struct FInventoryList& InArraySerializer);
+	void PostReplicatedAdd(const struct FInventoryList& InArraySerializer);
+	void PostReplicatedChange(const struct FInventoryList& InArraySerializer);
+
+protected:
+	void HandleReplicated(const struct FInventoryList& InArraySerializer);
 };
 
 USTRUCT(BlueprintType)
@@ -27,15 +87,103 @@ struct FInventoryList : public FFastArraySerializer
 		return FFastArraySerializer::FastArrayDeltaSerialize<FInventoryListItem, FInventoryList>(Items, DeltaParams, *this);
 	}
 
-	void AddItem(TSubclassOf<UItemStaticData> InItemStaticDataClass);
-	void AddItem(UInventoryItemInstance* InItemInstance);
+	void PostReplicatedReceive(const FFastArraySerializer::FPostReplicatedReceiveParameters& Parameters);
+
+	UInventoryItemInstance* AddItem(TSubclassOf<UItemStaticData> InItemStaticDataClass);
+	bool AddItem(UInventoryItemInstance* InItemInstance);
+
+	UInventoryItemInstance* RemoveItem(TSubclassOf<UItemStaticData> InItemStaticDataClass);
+	bool RemoveItem(UInventoryItemInstance* InItemInstance);
+
+	/** Tops up existing stacks of the item before opening new ones */
+	void AddStack(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 Count);
+
+	/** Takes from the newest stacks first, returns how many were removed */
+	int32 RemoveStack(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 Count);
 
-	void RemoveItem(TSubclassOf<UItemStaticData> InItemStaticDataClass);
+	int32 GetStackCount(TSubclassOf<UItemStaticData> InItemStaticDataClass) const;
 	TArray<FInventoryListItem>& GetItemsRef() { return Items; }
+	const TArray<FInventoryListItem>& GetItems() const { return Items; }
+
+	/** Appends a saved entry as it was stored, without merging it into other stacks */
+	UInventoryItemInstance* AddSnapshotItem(const FInventoryItemSnapshot& InItem);
+
+	void Empty();
+
+	/** Oldest item of exactly this static data class */
+	UInventoryItemInstance* FindItem(TSubclassOf<UItemStaticData> InItemStaticDataClass) const;
+
+	/** Server only, invalid for items not in the list */
+	FInventorySlotHandle GetSlotHandle(const UInventoryItemInstance* InItemInstance) const;
+
+	/** The entry the handle was taken from, or null once that entry has left the list */
+	const FInventoryListItem* ResolveSlotHandle(const FInventorySlotHandle& Handle) const;
+
+	bool Contains(const UInventoryItemInstance* InItemInstance) const;
+
+	/** The equippable item after the given one, wrapping around, or the first equippable item */
+	UInventoryItemInstance* FindNextEquippable(const UInventoryItemInstance* InItemInstance) const;
+
+	int32 NumEquippable() const { return EquippableItems.Num(); }
+
+	UPROPERTY(NotReplicated)
+	TObjectPtr<UInventoryComponent> OwnerComponent = nullptr;
 
 protected:
 	UPROPERTY()
 	TArray<FInventoryListItem> Items;
+
+	void RemoveSlot(int32 Slot);
+
+	void IndexItem(int32 Slot);
+
+	void UnindexItem(int32 Slot);
+
+	int32 AcquireSlotHandle(int32 Slot);
+
+	void ReleaseSlotHandle(int32 HandleIndex);
+
+	int32 GetSlot(const UInventoryItemInstance* InItemInstance) const;
+
+	void AdjustStackCount(TSubclassOf<UItemStaticData> InItemStaticDataClass, int32 Delta);
+
+	/** Adds the instance to the lookups both the server and the owning client keep */
+	void IndexInstance(UInventoryItemInstance* InItemInstance);
+
+	void UnindexInstance(UInventoryItemInstance* InItemInstance);
+
+	struct FSlotHandleEntry
+	{
+		int32 Slot = INDEX_NONE;
+
+		uint32 Generation = 0;
+	};
+
+	/** Server only, current slot of every handle, a handle's generation moves on when its entry is removed so stale handles stop resolving */
+	TArray<FSlotHandleEntry> SlotHandles;
+
+	TArray<int32> FreeSlotHandles;
+
+	/** Server only, handles rather than slots so removals only have to update the handle table */
+	TMap<const UInventoryItemInstance*, int32> HandleByInstance;
+
+	/** Instances under their static data class in the order they were added, rebuilt on clients from the entry callbacks */
+	TMap<TSubclassOf<UItemStaticData>, TArray<UInventoryItemInstance*, TInlineAllocator<2>>> ItemsByClass;
+
+	TArray<UInventoryItemInstance*> EquippableItems;
+
+	TMap<const UInventoryItemInstance*, int32> EquippableIndexByInstance;
+
+	/** Server only, handles of each stack class in the order they were opened */
+	TMap<TSubclassOf<UItemStaticData>, TArray<int32, TInlineAllocator<2>>> StackHandlesByClass;
+
+	/** Total count of each stack class, rebuilt on clients from the entry callbacks */
+	TMap<TSubclassOf<UItemStaticData>, int32> StackCountByClass;
+
+	/** Stack classes touched by the replication update being received, filled by the entry callbacks */
+	mutable TSet<TSubclassOf<UItemStaticData>> DirtyStackClasses;
+
+	friend struct FInventoryListItem;
 };
 
 template<>
@@ -4,13 +4,57 @@
 #include "WeaponItemActor.h"
 #include "Inventory/InventoryItemInstance.h"
 #include "ActionGameTypes.h"
-#include "Kismet/GameplayStatics.h"
-#include "PhysicalMaterials/AG_PhysicalMaterial.h"
-#include "NiagaraFunctionLibrary.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "Subsystems/CosmeticEffectsSubsystem.h"
+#include "Net/UnrealNetwork.h"
+#include "GameFramework/Character.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/StaticMesh.h"
+#include "Sound/SoundBase.h"
+#include "ActionGameStatics.h"
+
+// Simulated proxies only ever need the last few shots, older slots are overwritten
+static const int32 ShotRingSize = 8;
+
+void FWeaponShotEvent::PostReplicatedAdd(const FWeaponShotList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleShotReplicated(*this);
+	}
+}
+
+void FWeaponShotEvent::PostReplicatedChange(const FWeaponShotList& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->HandleShotReplicated(*this);
+	}
+}
 
 AWeaponItemActor::AWeaponItemActor()
 {
+	// Only connections that can see the wielder need its shots
+	bNetUseOwnerRelevancy = true;
+
+	RecentShots.Owner = this;
+}
+
+void AWeaponItemActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// The owning client already played its own shots locally
+	DOREPLIFETIME_CONDITION(AWeaponItemActor, RecentShots, COND_SkipOwner);
+}
+
+void AWeaponItemActor::PostNetReceive()
+{
+	Super::PostNetReceive();
 
+	bShotStreamInitialized = true;
 }
 
 const UWeaponStaticData* AWeaponItemActor::GetWeaponStaticData() const
@@ -27,39 +71,78 @@ void AWeaponItemActor::PlayWeaponEffects(const FHitResult& InHitResult)
 {
 	if (HasAuthority())
 	{
-		MulticastPlayWeaponEffects(InHitResult);
-	}
-	else
-	{
-		PlayWeaponEffectsInternal(InHitResult);
+		RecordShot(InHitResult);
 	}
+
+	PlayWeaponEffectsInternal(InHitResult.bBlockingHit, InHitResult.ImpactPoint, InHitResult.ImpactNormal, InHitResult.PhysMaterial.Get());
+}
+
+void AWeaponItemActor::RecordShot(const FHitResult& InHitResult)
+{
+	++ShotCounter;
+
+	// Counters 1..ShotRingSize fill the ring, later shots overwrite the oldest slot
+	const int32 Slot = (ShotCounter + ShotRingSize - 1) % ShotRingSize;
+
+	FWeaponShotEvent* Shot = RecentShots.Shots.IsValidIndex(Slot) ? &RecentShots.Shots[Slot] : &RecentShots.Shots.AddDefaulted_GetRef();
+
+	Shot->ImpactPoint = InHitResult.ImpactPoint;
+	Shot->ImpactNormal = InHitResult.ImpactNormal;
+	Shot->PhysicalMaterial = InHitResult.PhysMaterial.Get();
+	Shot->ShotCounter = ShotCounter;
+	Shot->bHit = InHitResult.bBlockingHit;
+
+	RecentShots.MarkItemDirty(*Shot);
 }
 
-void AWeaponItemActor::MulticastPlayWeaponEffects_Implementation(const FHitResult& InHitResult)
+void AWeaponItemActor::HandleShotReplicated(const FWeaponShotEvent& Shot)
 {
-	if (!Owner || Owner->GetLocalRole() != ROLE_AutonomousProxy)
+	if (!bShotStreamInitialized) return;
+
+	PlayWeaponEffectsInternal(Shot.bHit, Shot.ImpactPoint, Shot.ImpactNormal, Shot.PhysicalMaterial);
+
+	if (Shot.ShotCounter != ShotCounter)
 	{
-		PlayWeaponEffectsInternal(InHitResult);
+		ShotCounter = Shot.ShotCounter;
+
+		PlayFireMontage();
 	}
 }
 
-void AWeaponItemActor::PlayWeaponEffectsInternal(const FHitResult& InHitResult)
+void AWeaponItemActor::PlayWeaponEffectsInternal(bool bHit, const FVector& ImpactPoint, const FVector& ImpactNormal, const UPhysicalMaterial* PhysicalMaterial)
 {
-	if (InHitResult.PhysMaterial.Get())
-	{
-		UAG_PhysicalMaterial* PhysicalMaterial = Cast<UAG_PhysicalMaterial>(InHitResult.PhysMaterial.Get());
+	UCosmeticEffectsSubsystem* CosmeticEffects = UCosmeticEffectsSubsystem::Get(this);
 
-		if (PhysicalMaterial)
-		{
-			UGameplayStatics::PlaySoundAtLocation(this, PhysicalMaterial->PointImpactSound, InHitResult.ImpactPoint);
+	if (!CosmeticEffects) return;
 
-			UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, PhysicalMaterial->PointImpactVFX, InHitResult.ImpactPoint);
-		}		
+	if (bHit)
+	{
+		CosmeticEffects->PlaySurfaceEffect(PhysicalMaterial, ESurfaceEffectType::Impact, ImpactPoint, ImpactNormal.Rotation(), this);
 	}
 
 	if (const UWeaponStaticData* WeaponData = GetWeaponStaticData())
 	{
-		UGameplayStatics::PlaySoundAtLocation(this, WeaponData->AttackSound, GetActorLocation());
+		// Streamed when the item became relevant or entered an inventory, a shot before it arrives plays without the sound
+		CosmeticEffects->PlaySoundAtLocation(WeaponData->AttackSound.Get(), GetActorLocation());
+	}
+}
+
+void AWeaponItemActor::PlayFireMontage()
+{
+	const UWeaponStaticData* WeaponData = GetWeaponStaticData();
+
+	ACharacter* Character = Cast<ACharacter>(Owner);
+
+	UAnimInstance* AnimInstance = Character && Character->GetMesh() ? Character->GetMesh()->GetAnimInstance() : nullptr;
+
+	UAnimMontage* AttackMontage = UActionGameStatics::GetWeaponAttackMontage(WeaponData);
+
+	if (!AttackMontage || !AnimInstance) return;
+
+	// Automatic fire keeps the montage running rather than restarting it every shot
+	if (!AnimInstance->Montage_IsPlaying(AttackMontage))
+	{
+		AnimInstance->Montage_Play(AttackMontage);
 	}
 }
 
@@ -67,27 +150,31 @@ void AWeaponItemActor::InitInternal()
 {
 	Super::InitInternal();
 
+	// The actor lives as long as its item instance, the mesh only needs creating once
+	if (MeshComponent) return;
+
 	if (const UWeaponStaticData* WeaponData = GetWeaponStaticData())
 	{
-		if (WeaponData->SkeletalMesh)
+		// Prefetched when the item entered the inventory, only blocks if that has not finished yet
+		if (USkeletalMesh* SkeletalMesh = WeaponData->SkeletalMesh.LoadSynchronous())
 		{
 			USkeletalMeshComponent* SkeletalComp = NewObject<USkeletalMeshComponent>(this, USkeletalMeshComponent::StaticClass(), TEXT("MeshComponent"));
 			if (SkeletalComp)
 			{
 				SkeletalComp->RegisterComponent();
-				SkeletalComp->SetSkeletalMesh(WeaponData->SkeletalMesh);
+				SkeletalComp->SetSkeletalMesh(SkeletalMesh);
 				SkeletalComp->AttachToComponent(GetRootComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
 
 				MeshComponent = SkeletalComp;
 			}
 		}
-		else if (WeaponData->StaticMesh)
+		else if (UStaticMesh* StaticMesh = WeaponData->StaticMesh.LoadSynchronous())
 		{
 			UStaticMeshComponent* StaticComp = NewObject<UStaticMeshComponent>(this, UStaticMeshComponent::StaticClass(), TEXT("MeshComponent"));
 			if (StaticComp)
 			{
 				StaticComp->RegisterComponent();
-				StaticComp->SetStaticMesh(WeaponData->StaticMesh);
+				StaticComp->SetStaticMesh(StaticMesh);
 				StaticComp->AttachToComponent(GetRootComponent(), FAttachmentTransformRules::SnapToTargetNotIncludingScale);
 
 				MeshComponent = StaticComp;
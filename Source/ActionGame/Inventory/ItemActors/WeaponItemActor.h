@@ -4,8 +4,60 @@
 
 #include "CoreMinimal.h"
 #include "Actors/ItemActor.h"
+#include "Net/Serialization/FastArraySerializer.h"
 #include "WeaponItemActor.generated.h"
 
+class AWeaponItemActor;
+class UPhysicalMaterial;
+
+USTRUCT()
+struct FWeaponShotEvent : public FFastArraySerializerItem
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	FVector_NetQuantize ImpactPoint;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal ImpactNormal;
+
+	/** The material itself rather than its surface type, which several materials may share. Sent as a net GUID after its first use */
+	UPROPERTY()
+	TObjectPtr<UPhysicalMaterial> PhysicalMaterial = nullptr;
+
+	UPROPERTY()
+	uint8 ShotCounter = 0;
+
+	UPROPERTY()
+	bool bHit = false;
+
+	void PostReplicatedAdd(const struct FWeaponShotList& InArraySerializer);
+	void PostReplicatedChange(const struct FWeaponShotList& InArraySerializer);
+};
+
+USTRUCT()
+struct FWeaponShotList : public FFastArraySerializer
+{
+	GENERATED_USTRUCT_BODY()
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParams)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FWeaponShotEvent, FWeaponShotList>(Shots, DeltaParams, *this);
+	}
+
+	UPROPERTY()
+	TArray<FWeaponShotEvent> Shots;
+
+	UPROPERTY(NotReplicated)
+	TObjectPtr<AWeaponItemActor> Owner = nullptr;
+};
+
+template<>
+struct TStructOpsTypeTraits<FWeaponShotList> : public TStructOpsTypeTraitsBase2<FWeaponShotList>
+{
+	enum { WithNetDeltaSerializer = true };
+};
+
 /**
  * 
  */
@@ -17,6 +69,10 @@ class ACTIONGAME_API AWeaponItemActor : public AItemActor
 public:
 	AWeaponItemActor();
 
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	virtual void PostNetReceive() override;
+
 	const UWeaponStaticData* GetWeaponStaticData() const;
 
 	UFUNCTION(BlueprintPure)
@@ -29,13 +85,27 @@ public:
 
 protected:
 
-	UFUNCTION(NetMulticast, Reliable)
-	void MulticastPlayWeaponEffects(const FHitResult& InHitResult);
+	/** Recent shots, written as a ring so the stream stays a fixed size under automatic fire */
+	UPROPERTY(Replicated)
+	FWeaponShotList RecentShots;
+
+	uint8 ShotCounter = 0;
+
+	/** Shots already in the list when the actor first replicates are history, not new shots */
+	bool bShotStreamInitialized = false;
 
-	void PlayWeaponEffectsInternal(const FHitResult& InHitResult);
+	void RecordShot(const FHitResult& InHitResult);
+
+	void HandleShotReplicated(const FWeaponShotEvent& Shot);
+
+	void PlayWeaponEffectsInternal(bool bHit, const FVector& ImpactPoint, const FVector& ImpactNormal, const UPhysicalMaterial* PhysicalMaterial);
+
+	void PlayFireMontage();
 
 	UPROPERTY()
 	UMeshComponent* MeshComponent = nullptr;
 
 	virtual void InitInternal() override;
+
+	friend struct FWeaponShotEvent;
 };
@@ -5,6 +5,7 @@
 #include "AbilitySystemComponent.h"
 #include "AbilitySystemBlueprintLibrary.h"
 #include "ActionGameGameMode.h"
+#include "ActionGameGameplayTags.h"
 
 void AActionGamePlayerController::RestartPlayerIn(float InTime)
 {
@@ -19,7 +20,7 @@ void AActionGamePlayerController::OnPossess(APawn* aPawn)
 
 	if (UAbilitySystemComponent* AbilityComponent = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(aPawn))
 	{
-		DeathStateTagDelegate = AbilityComponent->RegisterGameplayTagEvent(FGameplayTag::RequestGameplayTag(TEXT("State.Dead")), EGameplayTagEventType::NewOrRemoved).AddUObject(this, &AActionGamePlayerController::OnPawnDeathStateChanged);
+		DeathStateTagDelegate = AbilityComponent->RegisterGameplayTagEvent(FActionGameGameplayTags::Get().StateDeadTag, EGameplayTagEventType::NewOrRemoved).AddUObject(this, &AActionGamePlayerController::OnPawnDeathStateChanged);
 	}
 }
 
@@ -31,7 +32,7 @@ void AActionGamePlayerController::OnUnPossess()
 	{
 		if (UAbilitySystemComponent* AbilityComponent = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(GetPawn()))
 		{
-			AbilityComponent->UnregisterGameplayTagEvent(DeathStateTagDelegate, FGameplayTag::RequestGameplayTag(TEXT("State.Dead")), EGameplayTagEventType::NewOrRemoved);
+			AbilityComponent->UnregisterGameplayTagEvent(DeathStateTagDelegate, FActionGameGameplayTags::Get().StateDeadTag, EGameplayTagEventType::NewOrRemoved);
 		}
 	}
 }
@@ -53,7 +54,7 @@ void AActionGamePlayerController::OnPawnDeathStateChanged(const FGameplayTag Cal
 		{
 			if (UAbilitySystemComponent* AbilityComponent = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(GetPawn()))
 			{
-				AbilityComponent->UnregisterGameplayTagEvent(DeathStateTagDelegate, FGameplayTag::RequestGameplayTag(TEXT("State.Dead")), EGameplayTagEventType::NewOrRemoved);
+				AbilityComponent->UnregisterGameplayTagEvent(DeathStateTagDelegate, FActionGameGameplayTags::Get().StateDeadTag, EGameplayTagEventType::NewOrRemoved);
 			}
 		}
 	}
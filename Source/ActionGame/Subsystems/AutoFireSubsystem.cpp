@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AutoFireSubsystem.h"
+#include "ActionGame.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Auto Fire Schedule"), STAT_AutoFireSchedule, STATGROUP_ActionGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Auto Fire Triggers"), STAT_AutoFireTriggers, STATGROUP_ActionGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Auto Fire Shots"), STAT_AutoFireShots, STATGROUP_ActionGame);
+
+static TAutoConsoleVariable<int32> CVarAutoFireMaxShotsPerFrame(
+	TEXT("AutoFire.MaxShotsPerFrame"),
+	16,
+	TEXT("Most shots a single trigger may catch up in one frame, the schedule skips ahead after a longer hitch"),
+	ECVF_Default
+);
+
+// Shots closer than this are not worth scheduling, guards against a zero fire rate
+static const double MinShotInterval = 0.001;
+
+void UAutoFireSubsystem::Deinitialize()
+{
+	ActiveTriggers.Reset();
+	CooldownEndTimes.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UAutoFireSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UAutoFireSubsystem::IsTickable() const
+{
+	return ActiveTriggers.Num() > 0 || CooldownEndTimes.Num() > 0;
+}
+
+TStatId UAutoFireSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAutoFireSubsystem, STATGROUP_Tickables);
+}
+
+bool UAutoFireSubsystem::StartAutoFire(UObject* Instigator, double ShotInterval, FOnAutoFireShot&& OnShot, uint32& OutAutoFireId)
+{
+	OutAutoFireId = 0;
+
+	UWorld* World = GetWorld();
+
+	if (!World || !OnShot.IsBound()) return false;
+
+	const double Now = World->GetTimeSeconds();
+
+	const uint32 AutoFireId = NextAutoFireId++;
+	OutAutoFireId = AutoFireId;
+
+	FAutoFireState& State = ActiveTriggers.Add(AutoFireId);
+	State.Instigator = Instigator;
+	State.OnShot = MoveTemp(OnShot);
+	State.ShotInterval = FMath::Max(ShotInterval, MinShotInterval);
+	State.NextShotTime = Now;
+
+	double CooldownEndTime = 0.;
+
+	if (CooldownEndTimes.RemoveAndCopyValue(Instigator, CooldownEndTime))
+	{
+		State.NextShotTime = FMath::Max(Now, CooldownEndTime);
+	}
+
+	// The first shot belongs to the frame the trigger was pulled
+	FireDueShots(AutoFireId, Now, CVarAutoFireMaxShotsPerFrame.GetValueOnGameThread());
+
+	return true;
+}
+
+void UAutoFireSubsystem::StopAutoFire(uint32 AutoFireId)
+{
+	FAutoFireState State;
+
+	if (ActiveTriggers.RemoveAndCopyValue(AutoFireId, State) && State.Instigator.IsValid())
+	{
+		CooldownEndTimes.Add(State.Instigator, State.NextShotTime);
+	}
+}
+
+void UAutoFireSubsystem::FireDueShots(uint32 AutoFireId, double Now, int32 MaxShots)
+{
+	int32 ShotsFired = 0;
+
+	// Shot callbacks may start or stop triggers, so the state is looked up again for every shot
+	while (FAutoFireState* State = ActiveTriggers.Find(AutoFireId))
+	{
+		if (State->NextShotTime > Now) break;
+
+		if (ShotsFired == MaxShots)
+		{
+			State->NextShotTime = Now + State->ShotInterval;
+			break;
+		}
+
+		const double ShotTime = State->NextShotTime;
+		const int32 ShotIndex = State->ShotCount++;
+
+		State->NextShotTime += State->ShotInterval;
+
+		const FOnAutoFireShot OnShot = State->OnShot;
+		OnShot.ExecuteIfBound(ShotIndex, ShotTime);
+
+		++ShotsFired;
+	}
+
+	INC_DWORD_STAT_BY(STAT_AutoFireShots, ShotsFired);
+}
+
+void UAutoFireSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AutoFireSchedule);
+
+	Super::Tick(DeltaTime);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	const int32 MaxShotsPerFrame = CVarAutoFireMaxShotsPerFrame.GetValueOnGameThread();
+
+	// Only fire the triggers active at the start of the frame
+	TArray<uint32, TInlineAllocator<16>> AutoFireIds;
+	ActiveTriggers.GenerateKeyArray(AutoFireIds);
+
+	for (const uint32 AutoFireId : AutoFireIds)
+	{
+		const FAutoFireState* State = ActiveTriggers.Find(AutoFireId);
+
+		// Nobody is left to fire for once the instigator or the shot callback's object is gone
+		if (State && (!State->Instigator.IsValid() || !State->OnShot.IsBound()))
+		{
+			ActiveTriggers.Remove(AutoFireId);
+			continue;
+		}
+
+		FireDueShots(AutoFireId, Now, MaxShotsPerFrame);
+	}
+
+	for (auto It = CooldownEndTimes.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid() || It.Value() <= Now)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	SET_DWORD_STAT(STAT_AutoFireTriggers, ActiveTriggers.Num());
+}
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AutoFireSubsystem.generated.h"
+
+DECLARE_DELEGATE_TwoParams(FOnAutoFireShot, int32 /*ShotIndex*/, double /*ShotTime*/);
+
+struct FAutoFireState
+{
+	TWeakObjectPtr<UObject> Instigator;
+
+	FOnAutoFireShot OnShot;
+
+	double ShotInterval = 0.;
+
+	/** World time the next shot is due, advanced by exactly one interval per shot */
+	double NextShotTime = 0.;
+
+	int32 ShotCount = 0;
+};
+
+/**
+ * Schedules automatic fire for every trigger held this frame on one absolute timeline.
+ * Intervals shorter than the frame emit several shots per tick, each stamped with the sub-frame time it was due, so the rate does not depend on the tick rate.
+ */
+UCLASS()
+class ACTIONGAME_API UAutoFireSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Starts firing every ShotInterval seconds, the first shot fires right away unless the previous burst is still cooling down.
+	 * OutAutoFireId is assigned before that first shot, so its callback can already stop the trigger.
+	 */
+	bool StartAutoFire(UObject* Instigator, double ShotInterval, FOnAutoFireShot&& OnShot, uint32& OutAutoFireId);
+
+	void StopAutoFire(uint32 AutoFireId);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	void FireDueShots(uint32 AutoFireId, double Now, int32 MaxShots);
+
+	TMap<uint32, FAutoFireState> ActiveTriggers;
+
+	/** Earliest time each instigator may fire again, so tapping faster than the fire rate is not faster than holding */
+	TMap<TWeakObjectPtr<UObject>, double> CooldownEndTimes;
+
+	uint32 NextAutoFireId = 1;
+};
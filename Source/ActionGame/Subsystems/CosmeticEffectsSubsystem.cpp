@@ -0,0 +1,295 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CosmeticEffectsSubsystem.h"
+#include "ActionGame.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "NiagaraFunctionLibrary.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "PhysicalMaterials/AG_PhysicalMaterial.h"
+#include "Sound/SoundConcurrency.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cosmetic Sounds Played"), STAT_CosmeticSoundsPlayed, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cosmetic Systems Spawned"), STAT_CosmeticSystemsSpawned, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cosmetic Effects Over Budget"), STAT_CosmeticEffectsOverBudget, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Surface Effects Culled"), STAT_SurfaceEffectsCulled, STATGROUP_ActionGame);
+
+static TAutoConsoleVariable<int32> CVarCosmeticMaxSoundsPerFrame(
+	TEXT("CosmeticEffects.MaxSoundsPerFrame"),
+	32,
+	TEXT("Maximum number of one shot sounds started per frame, extra requests are dropped"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarCosmeticMaxSystemsPerFrame(
+	TEXT("CosmeticEffects.MaxSystemsPerFrame"),
+	16,
+	TEXT("Maximum number of Niagara systems spawned per frame, extra requests are dropped"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarSurfaceEffectsCullDistance(
+	TEXT("CosmeticEffects.SurfaceCullDistance"),
+	6000.f,
+	TEXT("Surface effects further than this from the view are skipped, unless the local player caused them"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarSurfaceEffectsMaxFootsteps(
+	TEXT("CosmeticEffects.MaxFootstepSounds"),
+	8,
+	TEXT("Maximum number of footstep sounds playing at once, the farthest are stopped first. Applies when a world starts"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarSurfaceEffectsMaxImpacts(
+	TEXT("CosmeticEffects.MaxImpactSounds"),
+	12,
+	TEXT("Maximum number of impact sounds playing at once, the farthest are stopped first. Applies when a world starts"),
+	ECVF_Default
+);
+
+// Effects this close are never view culled, their particles can reach into view
+static const float SurfaceEffectsNearRadius = 500.f;
+
+bool UCosmeticEffectsSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_SERVER
+	return false;
+#else
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+#endif
+}
+
+void UCosmeticEffectsSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FootstepConcurrency = NewObject<USoundConcurrency>(this);
+	FootstepConcurrency->Concurrency.MaxCount = FMath::Max(CVarSurfaceEffectsMaxFootsteps.GetValueOnGameThread(), 1);
+	FootstepConcurrency->Concurrency.ResolutionRule = EMaxConcurrentResolutionRule::StopFarthestThenOldest;
+
+	ImpactConcurrency = NewObject<USoundConcurrency>(this);
+	ImpactConcurrency->Concurrency.MaxCount = FMath::Max(CVarSurfaceEffectsMaxImpacts.GetValueOnGameThread(), 1);
+	ImpactConcurrency->Concurrency.ResolutionRule = EMaxConcurrentResolutionRule::StopFarthestThenOldest;
+
+	BuildSurfaceTable();
+}
+
+void UCosmeticEffectsSubsystem::BuildSurfaceTable()
+{
+	SurfaceMaterials.SetNumZeroed(SurfaceType_Max);
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	TArray<FAssetData> MaterialAssets;
+	AssetRegistry.GetAssetsByClass(UAG_PhysicalMaterial::StaticClass()->GetClassPathName(), MaterialAssets, true);
+
+	TArray<FSoftObjectPath> MaterialPaths;
+
+	for (const FAssetData& MaterialAsset : MaterialAssets)
+	{
+		MaterialPaths.Add(MaterialAsset.ToSoftObjectPath());
+	}
+
+	if (MaterialPaths.Num() == 0) return;
+
+	// Streamed in the background, until then only hits that carry their own material play surface effects
+	SurfaceMaterialsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(MaterialPaths), FStreamableDelegate::CreateUObject(this, &UCosmeticEffectsSubsystem::OnSurfaceMaterialsLoaded));
+}
+
+void UCosmeticEffectsSubsystem::OnSurfaceMaterialsLoaded()
+{
+	if (!SurfaceMaterialsHandle) return;
+
+	TArray<UObject*> LoadedAssets;
+	SurfaceMaterialsHandle->GetLoadedAssets(LoadedAssets);
+
+	for (UObject* LoadedAsset : LoadedAssets)
+	{
+		UAG_PhysicalMaterial* PhysicalMaterial = Cast<UAG_PhysicalMaterial>(LoadedAsset);
+
+		if (!PhysicalMaterial || !SurfaceMaterials.IsValidIndex(PhysicalMaterial->SurfaceType)) continue;
+
+		TObjectPtr<UAG_PhysicalMaterial>& SurfaceMaterial = SurfaceMaterials[PhysicalMaterial->SurfaceType];
+
+		if (SurfaceMaterial)
+		{
+			UE_LOG(LogActionGame, Log, TEXT("%s and %s share a surface type, plain materials of that type play %s"), *GetNameSafe(SurfaceMaterial), *GetNameSafe(PhysicalMaterial), *GetNameSafe(SurfaceMaterial));
+			continue;
+		}
+
+		SurfaceMaterial = PhysicalMaterial;
+	}
+}
+
+bool UCosmeticEffectsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+UCosmeticEffectsSubsystem* UCosmeticEffectsSubsystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+
+	// PIE dedicated servers share the editor process, so the subsystem exists there and the net mode decides
+	if (World && World->GetNetMode() != NM_DedicatedServer)
+	{
+		return World->GetSubsystem<UCosmeticEffectsSubsystem>();
+	}
+
+	return nullptr;
+}
+
+void UCosmeticEffectsSubsystem::UpdateFrameBudget()
+{
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		SoundsThisFrame = 0;
+		SystemsThisFrame = 0;
+
+		const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+		const APlayerCameraManager* CameraManager = PlayerController ? PlayerController->PlayerCameraManager : nullptr;
+
+		bHasView = CameraManager != nullptr;
+
+		if (CameraManager)
+		{
+			ViewLocation = CameraManager->GetCameraLocation();
+			ViewDirection = CameraManager->GetCameraRotation().Vector();
+
+			// The horizontal FOV bounds the widest direction of the view, widened so effects at the screen corners survive
+			ViewCosHalfFOV = FMath::Cos(FMath::DegreesToRadians(FMath::Min(CameraManager->GetFOVAngle() * 0.5f + 15.f, 90.f)));
+		}
+	}
+}
+
+void UCosmeticEffectsSubsystem::PlaySoundAtLocation(USoundBase* Sound, const FVector& Location, float VolumeMultiplier, USoundConcurrency* Concurrency, bool bHighPriority)
+{
+	if (!Sound) return;
+
+	UpdateFrameBudget();
+
+	if (!bHighPriority && SoundsThisFrame >= CVarCosmeticMaxSoundsPerFrame.GetValueOnGameThread())
+	{
+		INC_DWORD_STAT(STAT_CosmeticEffectsOverBudget);
+		return;
+	}
+
+	++SoundsThisFrame;
+
+	UGameplayStatics::PlaySoundAtLocation(this, Sound, Location, VolumeMultiplier, 1.f, 0.f, nullptr, Concurrency);
+
+	INC_DWORD_STAT(STAT_CosmeticSoundsPlayed);
+}
+
+UNiagaraComponent* UCosmeticEffectsSubsystem::SpawnSystemAtLocation(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation, bool bHighPriority)
+{
+	if (!System) return nullptr;
+
+	UpdateFrameBudget();
+
+	if (!bHighPriority && SystemsThisFrame >= CVarCosmeticMaxSystemsPerFrame.GetValueOnGameThread())
+	{
+		INC_DWORD_STAT(STAT_CosmeticEffectsOverBudget);
+		return nullptr;
+	}
+
+	++SystemsThisFrame;
+
+	INC_DWORD_STAT(STAT_CosmeticSystemsSpawned);
+
+	// Pooled components return to the world's Niagara pool on completion instead of being destroyed
+	return UNiagaraFunctionLibrary::SpawnSystemAtLocation(this, System, Location, Rotation, FVector(1.f), false, true, ENCPoolMethod::AutoRelease, true);
+}
+
+void UCosmeticEffectsSubsystem::PlaySurfaceEffect(const UPhysicalMaterial* PhysicalMaterial, ESurfaceEffectType EffectType, const FVector& Location, const FRotator& Rotation, const AActor* Instigator)
+{
+	PlaySurfaceMaterialEffect(GetSurfaceMaterial(PhysicalMaterial), EffectType, Location, Rotation, Instigator);
+}
+
+void UCosmeticEffectsSubsystem::PlaySurfaceMaterialEffect(const UAG_PhysicalMaterial* PhysicalMaterial, ESurfaceEffectType EffectType, const FVector& Location, const FRotator& Rotation, const AActor* Instigator)
+{
+	if (!PhysicalMaterial) return;
+
+	UpdateFrameBudget();
+
+	// The local player's own footsteps and impacts are never dropped
+	const bool bHighPriority = IsLocallyInstigated(Instigator);
+
+	if (!bHighPriority && IsCulled(Location, false))
+	{
+		INC_DWORD_STAT(STAT_SurfaceEffectsCulled);
+		return;
+	}
+
+	if (EffectType == ESurfaceEffectType::Footstep)
+	{
+		PlaySoundAtLocation(PhysicalMaterial->FootstepSound, Location, 1.f, FootstepConcurrency, bHighPriority);
+		return;
+	}
+
+	PlaySoundAtLocation(PhysicalMaterial->PointImpactSound, Location, 1.f, ImpactConcurrency, bHighPriority);
+
+	// Sounds are heard from behind, particles only matter in view
+	if (bHighPriority || !IsCulled(Location, true))
+	{
+		SpawnSystemAtLocation(PhysicalMaterial->PointImpactVFX, Location, Rotation, bHighPriority);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_SurfaceEffectsCulled);
+	}
+}
+
+UAG_PhysicalMaterial* UCosmeticEffectsSubsystem::GetSurfaceMaterial(EPhysicalSurface SurfaceType) const
+{
+	return SurfaceMaterials.IsValidIndex(SurfaceType) ? SurfaceMaterials[SurfaceType].Get() : nullptr;
+}
+
+const UAG_PhysicalMaterial* UCosmeticEffectsSubsystem::GetSurfaceMaterial(const UPhysicalMaterial* PhysicalMaterial) const
+{
+	if (!PhysicalMaterial) return nullptr;
+
+	if (const UAG_PhysicalMaterial* SurfaceMaterial = Cast<UAG_PhysicalMaterial>(PhysicalMaterial))
+	{
+		return SurfaceMaterial;
+	}
+
+	return GetSurfaceMaterial(PhysicalMaterial->SurfaceType);
+}
+
+bool UCosmeticEffectsSubsystem::IsLocallyInstigated(const AActor* Instigator) const
+{
+	const APawn* Pawn = Cast<APawn>(Instigator);
+
+	if (!Pawn && Instigator)
+	{
+		Pawn = Cast<APawn>(Instigator->GetOwner());
+	}
+
+	return Pawn && Pawn->IsLocallyControlled();
+}
+
+bool UCosmeticEffectsSubsystem::IsCulled(const FVector& Location, bool bVisible) const
+{
+	if (!bHasView) return false;
+
+	const FVector ToLocation = Location - ViewLocation;
+	const float DistanceSquared = ToLocation.SizeSquared();
+
+	const float CullDistance = CVarSurfaceEffectsCullDistance.GetValueOnGameThread();
+
+	if (DistanceSquared > FMath::Square(CullDistance)) return true;
+
+	if (!bVisible || DistanceSquared < FMath::Square(SurfaceEffectsNearRadius)) return false;
+
+	return FVector::DotProduct(ToLocation, ViewDirection) < ViewCosHalfFOV * FMath::Sqrt(DistanceSquared);
+}
@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Chaos/ChaosEngineInterface.h"
+#include "CosmeticEffectsSubsystem.generated.h"
+
+class USoundBase;
+class USoundConcurrency;
+class UNiagaraSystem;
+class UNiagaraComponent;
+class UAG_PhysicalMaterial;
+class UPhysicalMaterial;
+struct FStreamableHandle;
+
+UENUM()
+enum class ESurfaceEffectType : uint8
+{
+	Footstep,
+	Impact,
+};
+
+/**
+ * Single entry point for fire and forget sounds and particle systems.
+ * Never created on dedicated servers, so callers can skip cosmetic work entirely when Get returns null.
+ * Niagara systems come from the world's component pool and both sounds and systems are capped per frame.
+ * Surface effects come from the hit's physical material and are culled by distance and view except those caused by the local player.
+ */
+UCLASS()
+class ACTIONGAME_API UCosmeticEffectsSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	static UCosmeticEffectsSubsystem* Get(const UObject* WorldContextObject);
+
+	/** High priority effects skip the per frame caps, for effects the local player caused */
+	void PlaySoundAtLocation(USoundBase* Sound, const FVector& Location, float VolumeMultiplier = 1.f, USoundConcurrency* Concurrency = nullptr, bool bHighPriority = false);
+
+	UNiagaraComponent* SpawnSystemAtLocation(UNiagaraSystem* System, const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator, bool bHighPriority = false);
+
+	/** Plays the material's footstep or impact effects, the instigator decides whether the effect may be culled */
+	void PlaySurfaceEffect(const UPhysicalMaterial* PhysicalMaterial, ESurfaceEffectType EffectType, const FVector& Location, const FRotator& Rotation, const AActor* Instigator);
+
+	UAG_PhysicalMaterial* GetSurfaceMaterial(EPhysicalSurface SurfaceType) const;
+
+	/** The material itself for our materials, plain engine materials fall back to the table by surface type */
+	const UAG_PhysicalMaterial* GetSurfaceMaterial(const UPhysicalMaterial* PhysicalMaterial) const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	void UpdateFrameBudget();
+
+	void BuildSurfaceTable();
+
+	void OnSurfaceMaterialsLoaded();
+
+	void PlaySurfaceMaterialEffect(const UAG_PhysicalMaterial* PhysicalMaterial, ESurfaceEffectType EffectType, const FVector& Location, const FRotator& Rotation, const AActor* Instigator);
+
+	bool IsLocallyInstigated(const AActor* Instigator) const;
+
+	bool IsCulled(const FVector& Location, bool bVisible) const;
+
+	/** Physical materials by surface type for plain engine materials, streamed in from the asset registry when the world starts */
+	UPROPERTY()
+	TArray<TObjectPtr<UAG_PhysicalMaterial>> SurfaceMaterials;
+
+	TSharedPtr<FStreamableHandle> SurfaceMaterialsHandle;
+
+	UPROPERTY()
+	TObjectPtr<USoundConcurrency> FootstepConcurrency;
+
+	UPROPERTY()
+	TObjectPtr<USoundConcurrency> ImpactConcurrency;
+
+	FVector ViewLocation = FVector::ZeroVector;
+
+	FVector ViewDirection = FVector::ForwardVector;
+
+	float ViewCosHalfFOV = 0.f;
+
+	bool bHasView = false;
+
+	uint64 BudgetFrame = 0;
+
+	int32 SoundsThisFrame = 0;
+
+	int32 SystemsThisFrame = 0;
+};
@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DebugDrawSubsystem.h"
+#include "ActionGame.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Debug Draw"), STAT_DebugDraw, STATGROUP_ActionGame);
+
+void UDebugDrawSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Called once after any console variables changed, so switching a debug view on or off is picked up the next frame
+	ConsoleVariableSinkHandle = IConsoleManager::Get().RegisterConsoleVariableSink_Handle(FConsoleCommandDelegate::CreateUObject(this, &UDebugDrawSubsystem::UpdateTickable));
+}
+
+void UDebugDrawSubsystem::Deinitialize()
+{
+	IConsoleManager::Get().UnregisterConsoleVariableSink_Handle(ConsoleVariableSinkHandle);
+
+	Entries.Reset();
+	bAnyEnabled = false;
+
+	Super::Deinitialize();
+}
+
+bool UDebugDrawSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UDebugDrawSubsystem::IsTickable() const
+{
+	return bAnyEnabled;
+}
+
+TStatId UDebugDrawSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDebugDrawSubsystem, STATGROUP_Tickables);
+}
+
+bool UDebugDrawSubsystem::IsEnabled(const FDebugDrawEntry& Entry)
+{
+	if (Entry.EnableCVar && Entry.EnableCVar->GetInt() == 0) return false;
+
+	return Entry.bObjectEnabled;
+}
+
+void UDebugDrawSubsystem::UpdateTickable()
+{
+	bAnyEnabled = Entries.ContainsByPredicate(&UDebugDrawSubsystem::IsEnabled);
+}
+
+void UDebugDrawSubsystem::RegisterDebugDraw(UObject* Object, IConsoleVariable* EnableCVar, FOnDebugDraw&& OnDraw, bool bObjectEnabled)
+{
+	if (!Object || !OnDraw.IsBound()) return;
+
+	FDebugDrawEntry& Entry = Entries.AddDefaulted_GetRef();
+	Entry.Object = Object;
+	Entry.EnableCVar = EnableCVar;
+	Entry.OnDraw = MoveTemp(OnDraw);
+	Entry.bObjectEnabled = bObjectEnabled;
+
+	bAnyEnabled = bAnyEnabled || IsEnabled(Entry);
+}
+
+void UDebugDrawSubsystem::UnregisterDebugDraw(UObject* Object)
+{
+	Entries.RemoveAllSwap([Object](const FDebugDrawEntry& Entry)
+	{
+		return Entry.Object == Object;
+	});
+
+	// Removing entries can only turn drawing off, so there is nothing to recount while it is already off
+	if (bAnyEnabled)
+	{
+		UpdateTickable();
+	}
+}
+
+void UDebugDrawSubsystem::SetDebugDrawEnabled(UObject* Object, bool bObjectEnabled)
+{
+	for (FDebugDrawEntry& Entry : Entries)
+	{
+		if (Entry.Object == Object)
+		{
+			Entry.bObjectEnabled = bObjectEnabled;
+		}
+	}
+
+	if (bObjectEnabled != bAnyEnabled)
+	{
+		UpdateTickable();
+	}
+}
+
+void UDebugDrawSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DebugDraw);
+
+	Super::Tick(DeltaTime);
+
+	Entries.RemoveAllSwap([](const FDebugDrawEntry& Entry)
+	{
+		return !Entry.Object.IsValid();
+	});
+
+	UpdateTickable();
+
+	// Draw callbacks may register or unregister, so the entries are walked by index
+	for (int32 Index = 0; Index < Entries.Num(); ++Index)
+	{
+		if (IsEnabled(Entries[Index]))
+		{
+			const FOnDebugDraw OnDraw = Entries[Index].OnDraw;
+			OnDraw.ExecuteIfBound();
+		}
+	}
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HAL/IConsoleManager.h"
+#include "DebugDrawSubsystem.generated.h"
+
+DECLARE_DELEGATE(FOnDebugDraw);
+
+struct FDebugDrawEntry
+{
+	TWeakObjectPtr<UObject> Object;
+
+	/** Draws only while this is on, always draws without one */
+	IConsoleVariable* EnableCVar = nullptr;
+
+	/** Per object switch checked along with the console variable, pushed by objects that decide for themselves */
+	bool bObjectEnabled = true;
+
+	FOnDebugDraw OnDraw;
+};
+
+/**
+ * Draws debug visualization for registered objects so they do not need a tick of their own.
+ * The subsystem only ticks while at least one registered object has its console variable and its own switch on,
+ * which is worked out again when a console variable changes or an entry changes rather than every frame.
+ */
+UCLASS()
+class ACTIONGAME_API UDebugDrawSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterDebugDraw(UObject* Object, IConsoleVariable* EnableCVar, FOnDebugDraw&& OnDraw, bool bObjectEnabled = true);
+
+	void UnregisterDebugDraw(UObject* Object);
+
+	/** Flips the object's own switch, objects with one call this whenever it changes */
+	void SetDebugDrawEnabled(UObject* Object, bool bObjectEnabled);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	static bool IsEnabled(const FDebugDrawEntry& Entry);
+
+	void UpdateTickable();
+
+	TArray<FDebugDrawEntry> Entries;
+
+	bool bAnyEnabled = false;
+
+	FConsoleVariableSinkHandle ConsoleVariableSinkHandle;
+};
@@ -0,0 +1,158 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitscanSubsystem.h"
+#include "ActionGame.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Shots Requested"), STAT_HitscanShotsRequested, STATGROUP_ActionGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Traces Issued"), STAT_HitscanTracesIssued, STATGROUP_ActionGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Shots Delivered"), STAT_HitscanShotsDelivered, STATGROUP_ActionGame);
+
+void UHitscanSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	WeaponTraceDelegate.BindUObject(this, &UHitscanSubsystem::OnWeaponTraceCompleted);
+}
+
+void UHitscanSubsystem::Deinitialize()
+{
+	WeaponTraceDelegate.Unbind();
+
+	PendingRequests.Reset();
+	CompletedShots.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UHitscanSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UHitscanSubsystem::IsTickable() const
+{
+	return CompletedShots.Num() > 0;
+}
+
+TStatId UHitscanSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitscanSubsystem, STATGROUP_Tickables);
+}
+
+uint32 UHitscanSubsystem::RequestShot(FHitscanRequest&& Request)
+{
+	UWorld* World = GetWorld();
+
+	if (!World) return 0;
+
+	const uint32 RequestId = NextRequestId++;
+
+	FHitscanRequest& PendingRequest = PendingRequests.Add(RequestId, MoveTemp(Request));
+
+	const FCollisionQueryParams QueryParams = MakeQueryParams(PendingRequest);
+
+	// Waiting on an async focus trace would push the muzzle trace, and the shot, another frame back
+	FHitResult FocusHit;
+	const bool bFocusHit = World->LineTraceSingleByChannel(FocusHit, PendingRequest.FocusStart, PendingRequest.FocusEnd, PendingRequest.TraceChannel, QueryParams);
+
+	const FVector WeaponTraceEnd = GetWeaponTraceEnd(PendingRequest, bFocusHit ? &FocusHit : nullptr);
+
+	World->AsyncLineTraceByChannel(EAsyncTraceType::Single, PendingRequest.MuzzleLocation, WeaponTraceEnd, PendingRequest.TraceChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &WeaponTraceDelegate, RequestId);
+
+	INC_DWORD_STAT(STAT_HitscanShotsRequested);
+	INC_DWORD_STAT_BY(STAT_HitscanTracesIssued, 2);
+
+	return RequestId;
+}
+
+void UHitscanSubsystem::CancelShot(uint32 RequestId)
+{
+	PendingRequests.Remove(RequestId);
+}
+
+void UHitscanSubsystem::ResolveShotNow(const FHitscanRequest& Request, FHitResult& OutHitResult)
+{
+	UWorld* World = GetWorld();
+
+	OutHitResult = FHitResult();
+
+	if (!World) return;
+
+	FHitResult FocusHit;
+	const bool bFocusHit = World->LineTraceSingleByChannel(FocusHit, Request.FocusStart, Request.FocusEnd, Request.TraceChannel, MakeQueryParams(Request));
+
+	const FVector WeaponTraceEnd = GetWeaponTraceEnd(Request, bFocusHit ? &FocusHit : nullptr);
+
+	if (!World->LineTraceSingleByChannel(OutHitResult, Request.MuzzleLocation, WeaponTraceEnd, Request.TraceChannel, MakeQueryParams(Request)))
+	{
+		OutHitResult.TraceStart = Request.MuzzleLocation;
+		OutHitResult.TraceEnd = WeaponTraceEnd;
+		OutHitResult.Location = WeaponTraceEnd;
+	}
+
+	INC_DWORD_STAT(STAT_HitscanShotsRequested);
+	INC_DWORD_STAT_BY(STAT_HitscanTracesIssued, 2);
+	INC_DWORD_STAT(STAT_HitscanShotsDelivered);
+}
+
+FCollisionQueryParams UHitscanSubsystem::MakeQueryParams(const FHitscanRequest& Request) const
+{
+	static const FName HitscanTraceName = TEXT("HitscanTrace");
+
+	// Impact effects pick their surface from the hit's physical material
+	FCollisionQueryParams QueryParams(HitscanTraceName, false);
+	QueryParams.bReturnPhysicalMaterial = true;
+	QueryParams.AddIgnoredActor(Request.Shooter.Get());
+
+	return QueryParams;
+}
+
+FVector UHitscanSubsystem::GetWeaponTraceEnd(const FHitscanRequest& Request, const FHitResult* FocusHit)
+{
+	const FVector FocusLocation = FocusHit ? FocusHit->Location : Request.FocusEnd;
+
+	return Request.MuzzleLocation + (FocusLocation - Request.MuzzleLocation).GetSafeNormal() * Request.TraceDistance;
+}
+
+void UHitscanSubsystem::OnWeaponTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	// Cancelled while the trace was in flight
+	if (!PendingRequests.Contains(Datum.UserData)) return;
+
+	FHitscanResult& Result = CompletedShots.AddDefaulted_GetRef();
+	Result.RequestId = Datum.UserData;
+
+	if (const FHitResult* WeaponHit = FHitResult::GetFirstBlockingHit(Datum.OutHits))
+	{
+		Result.HitResult = *WeaponHit;
+	}
+	else
+	{
+		Result.HitResult.TraceStart = Datum.Start;
+		Result.HitResult.TraceEnd = Datum.End;
+		Result.HitResult.Location = Datum.End;
+	}
+}
+
+void UHitscanSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Callbacks may request new shots, so deliver from a local copy
+	TArray<FHitscanResult> ShotsToDeliver = MoveTemp(CompletedShots);
+	CompletedShots.Reset();
+
+	for (const FHitscanResult& Result : ShotsToDeliver)
+	{
+		FHitscanRequest Request;
+
+		if (PendingRequests.RemoveAndCopyValue(Result.RequestId, Request))
+		{
+			Request.OnCompleted.ExecuteIfBound(Result.RequestId, Request, Result.HitResult);
+
+			INC_DWORD_STAT(STAT_HitscanShotsDelivered);
+		}
+	}
+}
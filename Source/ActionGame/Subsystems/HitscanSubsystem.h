@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "HitscanSubsystem.generated.h"
+
+struct FHitscanRequest;
+
+DECLARE_DELEGATE_ThreeParams(FOnHitscanCompleted, uint32 /*RequestId*/, const FHitscanRequest& /*Request*/, const FHitResult& /*HitResult*/);
+
+struct FHitscanRequest
+{
+	FVector FocusStart = FVector::ZeroVector;
+
+	/** Camera aim before spread, FocusEnd lies along it spread by the shot's seed */
+	FVector AimDirection = FVector::ForwardVector;
+
+	FVector FocusEnd = FVector::ZeroVector;
+
+	FVector MuzzleLocation = FVector::ZeroVector;
+
+	float TraceDistance = 0.f;
+
+	ECollisionChannel TraceChannel = ECC_Visibility;
+
+	TWeakObjectPtr<AActor> Shooter;
+
+	int32 ShotIndex = 0;
+
+	int32 PelletIndex = 0;
+
+	/** Server world time as estimated by the shooter when the shot was fired, the server rewinds to it when validating the hit */
+	float ShotTimestamp = 0.f;
+
+	FOnHitscanCompleted OnCompleted;
+};
+
+struct FHitscanResult
+{
+	uint32 RequestId = 0;
+
+	FHitResult HitResult;
+};
+
+/**
+ * Collects every hitscan shot fired during a frame and resolves their muzzle traces as async traces.
+ * The camera focus trace runs when the shot is requested, so a shot is delivered the frame after it was fired, in one pass when the subsystem ticks.
+ */
+UCLASS()
+class ACTIONGAME_API UHitscanSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	uint32 RequestShot(FHitscanRequest&& Request);
+
+	/** Resolves a shot with blocking traces right away, for shots whose result must go out before the frame ends instead of one frame later */
+	void ResolveShotNow(const FHitscanRequest& Request, FHitResult& OutHitResult);
+
+	void CancelShot(uint32 RequestId);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	FCollisionQueryParams MakeQueryParams(const FHitscanRequest& Request) const;
+
+	/** The muzzle trace heads for whatever the camera focus trace hit */
+	static FVector GetWeaponTraceEnd(const FHitscanRequest& Request, const FHitResult* FocusHit);
+
+	void OnWeaponTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	FTraceDelegate WeaponTraceDelegate;
+
+	TMap<uint32, FHitscanRequest> PendingRequests;
+
+	TArray<FHitscanResult> CompletedShots;
+
+	uint32 NextRequestId = 1;
+};
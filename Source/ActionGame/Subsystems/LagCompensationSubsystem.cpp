@@ -0,0 +1,300 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LagCompensationSubsystem.h"
+#include "ActionGame.h"
+#include "Components/CapsuleComponent.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+DECLARE_CYCLE_STAT(TEXT("Lag Compensation Record"), STAT_LagCompensationRecord, STATGROUP_ActionGame);
+DECLARE_CYCLE_STAT(TEXT("Lag Compensation Rewind"), STAT_LagCompensationRewind, STATGROUP_ActionGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Lag Compensated Characters"), STAT_LagCompensatedCharacters, STATGROUP_ActionGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Lag Compensation History Frames"), STAT_LagCompensationHistoryFrames, STATGROUP_ActionGame);
+DECLARE_MEMORY_STAT(TEXT("Lag Compensation Memory"), STAT_LagCompensationMemory, STATGROUP_ActionGame);
+
+static TAutoConsoleVariable<int32> CVarLagCompensationEnabled(
+	TEXT("LagCompensation.Enabled"),
+	1,
+	TEXT("Rewind character hitboxes to the shooter's view when validating hitscan shots")
+	TEXT(" 0: Off\n")
+	TEXT(" 1: On\n"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarLagCompensationHistoryFrames(
+	TEXT("LagCompensation.HistoryFrames"),
+	64,
+	TEXT("Number of poses kept per character, applies to characters registered after the change"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarLagCompensationMaxRewind(
+	TEXT("LagCompensation.MaxRewindTime"),
+	0.4f,
+	TEXT("Maximum time in seconds a shot may be rewound"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarShowLagCompensation(
+	TEXT("ShowDebugLagCompensation"),
+	0,
+	TEXT("Draws the rewound capsules used to validate shots")
+	TEXT(" 0: Off\n")
+	TEXT(" 1: On\n"),
+	ECVF_Cheat
+);
+
+void FLagCompensationHistory::Record(const FLagCompensationFrame& Frame)
+{
+	Frames[Head] = Frame;
+	Head = (Head + 1) % Frames.Num();
+	Num = FMath::Min(Num + 1, Frames.Num());
+}
+
+bool FLagCompensationHistory::GetFrameAtTime(float Timestamp, FLagCompensationFrame& OutFrame) const
+{
+	if (Num == 0) return false;
+
+	// Newest to oldest, the first frame at or before the timestamp brackets it with the one after
+	for (int32 Age = 0; Age < Num; ++Age)
+	{
+		const FLagCompensationFrame& Older = GetFrame(Age);
+
+		if (Older.Timestamp <= Timestamp)
+		{
+			if (Age == 0)
+			{
+				OutFrame = Older;
+				return true;
+			}
+
+			const FLagCompensationFrame& Newer = GetFrame(Age - 1);
+			const float Alpha = (Timestamp - Older.Timestamp) / FMath::Max(Newer.Timestamp - Older.Timestamp, KINDA_SMALL_NUMBER);
+
+			OutFrame.Timestamp = Timestamp;
+			OutFrame.Center = FMath::Lerp(Older.Center, Newer.Center, Alpha);
+			OutFrame.HalfHeight = FMath::Lerp(Older.HalfHeight, Newer.HalfHeight, Alpha);
+			OutFrame.Yaw = Older.Yaw + FRotator::NormalizeAxis(Newer.Yaw - Older.Yaw) * Alpha;
+			return true;
+		}
+	}
+
+	// Older than the whole history, use the oldest pose we have
+	OutFrame = GetFrame(Num - 1);
+	return true;
+}
+
+void ULagCompensationSubsystem::Deinitialize()
+{
+	Histories.Empty();
+
+	UpdateMemoryStats();
+
+	Super::Deinitialize();
+}
+
+bool ULagCompensationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool ULagCompensationSubsystem::IsLagCompensationEnabled()
+{
+	return CVarLagCompensationEnabled.GetValueOnGameThread() != 0;
+}
+
+float ULagCompensationSubsystem::GetMaxRewindTime()
+{
+	return CVarLagCompensationMaxRewind.GetValueOnGameThread();
+}
+
+bool ULagCompensationSubsystem::IsTickable() const
+{
+	return Histories.Num() > 0;
+}
+
+TStatId ULagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+void ULagCompensationSubsystem::RegisterCharacter(ACharacter* Character)
+{
+	if (!Character || !Character->HasAuthority()) return;
+
+	if (Histories.ContainsByPredicate([Character](const FLagCompensationHistory& History) { return History.Character == Character; })) return;
+
+	FLagCompensationHistory& History = Histories.AddDefaulted_GetRef();
+	History.Character = Character;
+	History.Radius = Character->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	History.Frames.SetNumZeroed(FMath::Clamp(CVarLagCompensationHistoryFrames.GetValueOnGameThread(), 2, 256));
+
+	UpdateMemoryStats();
+}
+
+void ULagCompensationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	SCOPE_CYCLE_COUNTER(STAT_LagCompensationRecord);
+
+	const float Timestamp = GetWorld()->GetTimeSeconds();
+
+	bool bRemovedHistory = false;
+
+	for (int32 i = Histories.Num() - 1; i >= 0; --i)
+	{
+		FLagCompensationHistory& History = Histories[i];
+
+		ACharacter* Character = History.Character.Get();
+
+		if (!Character)
+		{
+			Histories.RemoveAtSwap(i, 1, false);
+			bRemovedHistory = true;
+			continue;
+		}
+
+		const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+
+		FLagCompensationFrame Frame;
+		Frame.Timestamp = Timestamp;
+		Frame.Center = FVector3f(Capsule->GetComponentLocation());
+		Frame.HalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+		Frame.Yaw = Capsule->GetComponentRotation().Yaw;
+
+		History.Record(Frame);
+	}
+
+	if (bRemovedHistory)
+	{
+		UpdateMemoryStats();
+	}
+
+	SET_DWORD_STAT(STAT_LagCompensatedCharacters, Histories.Num());
+	SET_DWORD_STAT(STAT_LagCompensationHistoryFrames, Histories.Num() > 0 ? Histories[0].Frames.Num() : 0);
+}
+
+void ULagCompensationSubsystem::UpdateMemoryStats() const
+{
+	SIZE_T Bytes = Histories.GetAllocatedSize();
+
+	for (const FLagCompensationHistory& History : Histories)
+	{
+		Bytes += History.Frames.GetAllocatedSize();
+	}
+
+	SET_MEMORY_STAT(STAT_LagCompensationMemory, Bytes);
+}
+
+bool ULagCompensationSubsystem::LineTraceRewound(const FVector& Start, const FVector& End, float Timestamp, const AActor* IgnoreActor, FHitResult& OutHitResult) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_LagCompensationRewind);
+
+	const float MinTimestamp = GetWorld()->GetTimeSeconds() - CVarLagCompensationMaxRewind.GetValueOnGameThread();
+	const float RewindTimestamp = FMath::Max(Timestamp, MinTimestamp);
+
+	const bool bDebug = CVarShowLagCompensation.GetValueOnGameThread() != 0;
+
+	const FVector TraceDirection = (End - Start).GetSafeNormal();
+	const float TraceLength = FVector::Dist(Start, End);
+
+	float ClosestDistance = TraceLength;
+	ACharacter* HitCharacter = nullptr;
+	FLagCompensationFrame HitFrame;
+
+	for (const FLagCompensationHistory& History : Histories)
+	{
+		ACharacter* Character = History.Character.Get();
+
+		if (!Character || Character == IgnoreActor) continue;
+
+		FLagCompensationFrame Frame;
+
+		if (!History.GetFrameAtTime(RewindTimestamp, Frame)) continue;
+
+		const FVector Center(Frame.Center);
+		const FVector AxisOffset(0.f, 0.f, FMath::Max(Frame.HalfHeight - History.Radius, 0.f));
+
+		if (bDebug)
+		{
+			DrawDebugCapsule(GetWorld(), Center, Frame.HalfHeight, History.Radius, FQuat::Identity, FColor::Cyan, false, 2.f);
+		}
+
+		FVector OnTrace;
+		FVector OnAxis;
+		FMath::SegmentDistToSegmentSafe(Start, End, Center - AxisOffset, Center + AxisOffset, OnTrace, OnAxis);
+
+		const float DistanceSquared = FVector::DistSquared(OnTrace, OnAxis);
+
+		if (DistanceSquared > FMath::Square(History.Radius)) continue;
+
+		// Back off from the closest point to where the trace enters the capsule, exact when the trace is perpendicular to the axis
+		const float EntryDistance = FMath::Max(FVector::Dist(Start, OnTrace) - FMath::Sqrt(FMath::Square(History.Radius) - DistanceSquared), 0.f);
+
+		if (EntryDistance >= ClosestDistance) continue;
+
+		ClosestDistance = EntryDistance;
+		HitCharacter = Character;
+		HitFrame = Frame;
+
+		const FVector HitLocation = Start + TraceDirection * EntryDistance;
+
+		OutHitResult = FHitResult(Character, Character->GetCapsuleComponent(), HitLocation, (HitLocation - OnAxis).GetSafeNormal());
+		OutHitResult.TraceStart = Start;
+		OutHitResult.TraceEnd = End;
+		OutHitResult.Distance = EntryDistance;
+		OutHitResult.Time = TraceLength > 0.f ? EntryDistance / TraceLength : 0.f;
+		OutHitResult.bBlockingHit = true;
+	}
+
+	if (HitCharacter)
+	{
+		TraceRewoundMesh(HitCharacter, HitFrame, OutHitResult);
+	}
+
+	return HitCharacter != nullptr;
+}
+
+void ULagCompensationSubsystem::TraceRewoundMesh(ACharacter* Character, const FLagCompensationFrame& Frame, FHitResult& InOutHitResult) const
+{
+	const UCapsuleComponent* Capsule = Character->GetCapsuleComponent();
+	USkeletalMeshComponent* Mesh = Character->GetMesh();
+
+	// Rather than moving the mesh back, the trace is moved by the offset between the rewound and the current capsule
+	const FTransform RewoundTransform(FRotator(0.f, Frame.Yaw, 0.f), FVector(Frame.Center));
+	const FTransform CurrentTransform(FRotator(0.f, Capsule->GetComponentRotation().Yaw, 0.f), Capsule->GetComponentLocation());
+
+	const FVector Start = CurrentTransform.TransformPosition(RewoundTransform.InverseTransformPosition(InOutHitResult.TraceStart));
+	const FVector End = CurrentTransform.TransformPosition(RewoundTransform.InverseTransformPosition(InOutHitResult.TraceEnd));
+
+	static const FName RewoundMeshTraceName = TEXT("LagCompensationRewoundMesh");
+
+	FCollisionQueryParams QueryParams(RewoundMeshTraceName, false);
+	QueryParams.bReturnPhysicalMaterial = true;
+
+	FHitResult MeshHit;
+
+	if (Mesh && Mesh->LineTraceComponent(MeshHit, Start, End, QueryParams))
+	{
+		InOutHitResult.Component = Mesh;
+		InOutHitResult.PhysMaterial = MeshHit.PhysMaterial;
+		InOutHitResult.BoneName = MeshHit.BoneName;
+		InOutHitResult.Item = MeshHit.Item;
+		InOutHitResult.FaceIndex = MeshHit.FaceIndex;
+		InOutHitResult.Location = RewoundTransform.TransformPosition(CurrentTransform.InverseTransformPosition(MeshHit.Location));
+		InOutHitResult.ImpactPoint = InOutHitResult.Location;
+		InOutHitResult.Normal = RewoundTransform.TransformVectorNoScale(CurrentTransform.InverseTransformVectorNoScale(MeshHit.Normal));
+		InOutHitResult.ImpactNormal = RewoundTransform.TransformVectorNoScale(CurrentTransform.InverseTransformVectorNoScale(MeshHit.ImpactNormal));
+		InOutHitResult.Distance = FVector::Dist(InOutHitResult.TraceStart, InOutHitResult.Location);
+		InOutHitResult.Time = MeshHit.Time;
+		return;
+	}
+
+	// Passed between the limbs, the capsule stays the hitbox but the hit still gets the body's surface
+	InOutHitResult.PhysMaterial = Capsule->BodyInstance.GetSimplePhysicalMaterial();
+}
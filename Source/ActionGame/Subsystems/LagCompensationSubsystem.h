@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LagCompensationSubsystem.generated.h"
+
+class ACharacter;
+
+/** One recorded capsule pose, capsules stay upright so the center, half height and facing are enough */
+struct FLagCompensationFrame
+{
+	float Timestamp = 0.f;
+
+	FVector3f Center = FVector3f::ZeroVector;
+
+	float HalfHeight = 0.f;
+
+	float Yaw = 0.f;
+};
+
+/** Fixed size ring buffer of capsule poses for one character */
+struct FLagCompensationHistory
+{
+	TWeakObjectPtr<ACharacter> Character;
+
+	float Radius = 0.f;
+
+	TArray<FLagCompensationFrame> Frames;
+
+	int32 Head = 0;
+
+	int32 Num = 0;
+
+	void Record(const FLagCompensationFrame& Frame);
+
+	/** Capsule pose at the timestamp, interpolated between the two recorded frames around it */
+	bool GetFrameAtTime(float Timestamp, FLagCompensationFrame& OutFrame) const;
+
+	const FLagCompensationFrame& GetFrame(int32 Age) const { return Frames[(Head - 1 - Age + Frames.Num()) % Frames.Num()]; }
+};
+
+/**
+ * Server side history of character capsules used to validate hitscan shots against what the shooter saw.
+ * Every registered character records one pose per server tick into a ring buffer of LagCompensation.HistoryFrames entries.
+ */
+UCLASS()
+class ACTIONGAME_API ULagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCharacter(ACharacter* Character);
+
+	/**
+	 * Traces against the character capsules as they were at the timestamp and returns the closest hit.
+	 * The hit character's mesh is traced again moved to the rewound pose, for the physical material and bone of the hit.
+	 */
+	bool LineTraceRewound(const FVector& Start, const FVector& End, float Timestamp, const AActor* IgnoreActor, FHitResult& OutHitResult) const;
+
+	static bool IsLagCompensationEnabled();
+
+	static float GetMaxRewindTime();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	void UpdateMemoryStats() const;
+
+	/** Fills in the surface and bone of a rewound capsule hit from the character's mesh */
+	void TraceRewoundMesh(ACharacter* Character, const FLagCompensationFrame& Frame, FHitResult& InOutHitResult) const;
+
+	TArray<FLagCompensationHistory> Histories;
+};
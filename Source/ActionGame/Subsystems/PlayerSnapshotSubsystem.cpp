@@ -0,0 +1,302 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PlayerSnapshotSubsystem.h"
+#include "ActionGame.h"
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemBlueprintLibrary.h"
+#include "AbilitySystem/AttributeSets/AG_AttributeSetBase.h"
+#include "ActorComponents/InventoryComponent.h"
+#include "Async/Async.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DECLARE_CYCLE_STAT(TEXT("Player Snapshot Save"), STAT_PlayerSnapshotSave, STATGROUP_ActionGame);
+DECLARE_CYCLE_STAT(TEXT("Player Snapshot Restore"), STAT_PlayerSnapshotRestore, STATGROUP_ActionGame);
+
+static TAutoConsoleVariable<int32> CVarPlayerSnapshotWriteToDisk(
+	TEXT("PlayerSnapshot.WriteToDisk"),
+	1,
+	TEXT("Write player snapshots to the saved directory so loadouts survive a server restart")
+	TEXT(" 0: Memory only\n")
+	TEXT(" 1: Memory and disk\n"),
+	ECVF_Default
+);
+
+// 'AGPS', followed by the format version, bump the version whenever the layout below changes
+static const uint32 SnapshotMagic = 0x53504741;
+static const uint32 SnapshotVersion = 1;
+
+// Guards against allocating from a corrupt file
+static const int32 MaxSnapshotItems = 1024;
+
+void UPlayerSnapshotSubsystem::Deinitialize()
+{
+	// Nothing may still be writing when the process goes away
+	for (TPair<FString, UE::Tasks::FTask>& PendingWrite : PendingWrites)
+	{
+		PendingWrite.Value.Wait();
+	}
+
+	PendingWrites.Reset();
+	SnapshotData.Reset();
+
+	Super::Deinitialize();
+}
+
+void UPlayerSnapshotSubsystem::SavePlayer(APawn* Pawn)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PlayerSnapshotSave);
+
+	if (!Pawn || !Pawn->HasAuthority()) return;
+
+	const FString PlayerKey = GetPlayerKey(Pawn->GetPlayerState());
+
+	if (PlayerKey.IsEmpty()) return;
+
+	FPlayerSnapshot Snapshot;
+
+	if (UInventoryComponent* InventoryComponent = Pawn->FindComponentByClass<UInventoryComponent>())
+	{
+		InventoryComponent->SaveSnapshot(Snapshot.Inventory);
+	}
+
+	if (UAbilitySystemComponent* AbilitySystemComponent = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Pawn))
+	{
+		Snapshot.Health = AbilitySystemComponent->GetNumericAttributeBase(UAG_AttributeSetBase::GetHealthAttribute());
+		Snapshot.Stamina = AbilitySystemComponent->GetNumericAttributeBase(UAG_AttributeSetBase::GetStaminaAttribute());
+		Snapshot.MaxMovementSpeed = AbilitySystemComponent->GetNumericAttributeBase(UAG_AttributeSetBase::GetMaxMovementSpeedAttribute());
+	}
+
+	TArray<uint8>& Data = SnapshotData.FindOrAdd(PlayerKey);
+	Data.Reset();
+
+	FMemoryWriter Writer(Data);
+	SerializeSnapshot(Writer, Snapshot);
+
+	if (CVarPlayerSnapshotWriteToDisk.GetValueOnGameThread() == 0) return;
+
+	QueueFileTask(PlayerKey, [Path = GetSnapshotPath(PlayerKey), Data]()
+	{
+		FFileHelper::SaveArrayToFile(Data, *Path);
+	});
+}
+
+void UPlayerSnapshotSubsystem::ForgetPlayer(APawn* Pawn)
+{
+	if (!Pawn || !Pawn->HasAuthority()) return;
+
+	const FString PlayerKey = GetPlayerKey(Pawn->GetPlayerState());
+
+	if (PlayerKey.IsEmpty()) return;
+
+	SnapshotData.Remove(PlayerKey);
+
+	QueueFileTask(PlayerKey, [Path = GetSnapshotPath(PlayerKey)]()
+	{
+		IFileManager::Get().Delete(*Path, false, false, true);
+	});
+}
+
+void UPlayerSnapshotSubsystem::QueueFileTask(const FString& PlayerKey, TUniqueFunction<void()>&& Task)
+{
+	for (auto It = PendingWrites.CreateIterator(); It; ++It)
+	{
+		if (It.Value().IsCompleted())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	TArray<UE::Tasks::FTask, TInlineAllocator<1>> Prerequisites;
+
+	if (UE::Tasks::FTask* PendingWrite = PendingWrites.Find(PlayerKey))
+	{
+		Prerequisites.Add(*PendingWrite);
+	}
+
+	PendingWrites.Add(PlayerKey, UE::Tasks::Launch(UE_SOURCE_LOCATION, MoveTemp(Task), Prerequisites));
+}
+
+bool UPlayerSnapshotSubsystem::RestorePlayer(APawn* Pawn)
+{
+	if (!Pawn || !Pawn->HasAuthority()) return false;
+
+	const FString PlayerKey = GetPlayerKey(Pawn->GetPlayerState());
+
+	if (PlayerKey.IsEmpty()) return false;
+
+	if (SnapshotData.Contains(PlayerKey))
+	{
+		return ApplySnapshot(Pawn, PlayerKey);
+	}
+
+	// The file is read after any write still pending for the player, and decoded back on the game thread since that loads classes
+	TWeakObjectPtr<UPlayerSnapshotSubsystem> WeakThis(this);
+	TWeakObjectPtr<APawn> WeakPawn(Pawn);
+
+	QueueFileTask(PlayerKey, [WeakThis, WeakPawn, PlayerKey, Path = GetSnapshotPath(PlayerKey)]()
+	{
+		TArray<uint8> FileData;
+
+		if (!FFileHelper::LoadFileToArray(FileData, *Path, FILEREAD_Silent)) return;
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, WeakPawn, PlayerKey, FileData = MoveTemp(FileData)]() mutable
+		{
+			UPlayerSnapshotSubsystem* PlayerSnapshots = WeakThis.Get();
+			APawn* Pawn = WeakPawn.Get();
+
+			// The player may have left, or been saved again, while the file was read
+			if (!PlayerSnapshots || !Pawn || PlayerSnapshots->SnapshotData.Contains(PlayerKey) || GetPlayerKey(Pawn->GetPlayerState()) != PlayerKey) return;
+
+			PlayerSnapshots->SnapshotData.Add(PlayerKey, MoveTemp(FileData));
+			PlayerSnapshots->ApplySnapshot(Pawn, PlayerKey);
+		});
+	});
+
+	return true;
+}
+
+bool UPlayerSnapshotSubsystem::ApplySnapshot(APawn* Pawn, const FString& PlayerKey)
+{
+	SCOPE_CYCLE_COUNTER(STAT_PlayerSnapshotRestore);
+
+	const TArray<uint8>* Data = SnapshotData.Find(PlayerKey);
+
+	if (!Data) return false;
+
+	FPlayerSnapshot Snapshot;
+
+	FMemoryReader Reader(*Data);
+
+	if (!SerializeSnapshot(Reader, Snapshot))
+	{
+		UE_LOG(LogActionGame, Warning, TEXT("Discarding unreadable player snapshot for %s"), *PlayerKey);
+
+		SnapshotData.Remove(PlayerKey);
+		return false;
+	}
+
+	if (UInventoryComponent* InventoryComponent = Pawn->FindComponentByClass<UInventoryComponent>())
+	{
+		InventoryComponent->LoadSnapshot(Snapshot.Inventory);
+	}
+
+	if (UAbilitySystemComponent* AbilitySystemComponent = UAbilitySystemBlueprintLibrary::GetAbilitySystemComponent(Pawn))
+	{
+		AbilitySystemComponent->SetNumericAttributeBase(UAG_AttributeSetBase::GetHealthAttribute(), Snapshot.Health);
+		AbilitySystemComponent->SetNumericAttributeBase(UAG_AttributeSetBase::GetStaminaAttribute(), Snapshot.Stamina);
+		AbilitySystemComponent->SetNumericAttributeBase(UAG_AttributeSetBase::GetMaxMovementSpeedAttribute(), Snapshot.MaxMovementSpeed);
+	}
+
+	return true;
+}
+
+FString UPlayerSnapshotSubsystem::GetPlayerKey(const APlayerState* PlayerState)
+{
+	if (!PlayerState) return FString();
+
+	const FUniqueNetIdRepl& UniqueId = PlayerState->GetUniqueId();
+
+	return UniqueId.IsValid() ? UniqueId.ToString() : PlayerState->GetPlayerName();
+}
+
+FString UPlayerSnapshotSubsystem::GetSnapshotPath(const FString& PlayerKey)
+{
+	return FPaths::ProjectSavedDir() / TEXT("PlayerSnapshots") / FPaths::MakeValidFileName(PlayerKey) + TEXT(".bin");
+}
+
+bool UPlayerSnapshotSubsystem::SerializeSnapshot(FArchive& Ar, FPlayerSnapshot& Snapshot)
+{
+	uint32 Magic = SnapshotMagic;
+	uint32 Version = SnapshotVersion;
+
+	Ar << Magic;
+	Ar << Version;
+
+	if (Magic != SnapshotMagic || Version > SnapshotVersion) return false;
+
+	TArray<FInventoryItemSnapshot>& Items = Snapshot.Inventory.Items;
+
+	// Static data classes are stored once by path, items refer to them by index
+	TArray<FString> ClassPaths;
+	TArray<uint16> ClassIndices;
+
+	if (Ar.IsSaving())
+	{
+		TMap<UClass*, uint16> ClassIndexByClass;
+
+		for (const FInventoryItemSnapshot& Item : Items)
+		{
+			UClass* ItemClass = Item.ItemStaticDataClass.Get();
+
+			if (const uint16* ClassIndex = ClassIndexByClass.Find(ItemClass))
+			{
+				ClassIndices.Add(*ClassIndex);
+				continue;
+			}
+
+			const uint16 ClassIndex = (uint16)ClassPaths.Add(FSoftClassPath(ItemClass).ToString());
+
+			ClassIndexByClass.Add(ItemClass, ClassIndex);
+			ClassIndices.Add(ClassIndex);
+		}
+	}
+
+	int32 NumClasses = ClassPaths.Num();
+
+	Ar << NumClasses;
+
+	if (Ar.IsLoading())
+	{
+		// Every path takes at least its length, so a count the remaining data cannot hold is corrupt
+		if (NumClasses < 0 || NumClasses > MaxSnapshotItems || NumClasses * (int64)sizeof(int32) > Ar.TotalSize() - Ar.Tell()) return false;
+
+		ClassPaths.SetNum(NumClasses);
+	}
+
+	for (FString& ClassPath : ClassPaths)
+	{
+		Ar << ClassPath;
+	}
+
+	int32 NumItems = Items.Num();
+
+	Ar << NumItems;
+
+	if (Ar.IsLoading())
+	{
+		if (Ar.IsError() || NumItems < 0 || NumItems > MaxSnapshotItems) return false;
+
+		Items.SetNum(NumItems);
+		ClassIndices.SetNumZeroed(NumItems);
+	}
+
+	for (int32 Index = 0; Index < NumItems; ++Index)
+	{
+		FInventoryItemSnapshot& Item = Items[Index];
+
+		Ar << ClassIndices[Index];
+		Ar << Item.StackCount;
+		Ar << Item.StateFlags;
+
+		if (Ar.IsLoading() && ClassPaths.IsValidIndex(ClassIndices[Index]))
+		{
+			// Items whose static data no longer exists are dropped on restore
+			Item.ItemStaticDataClass = FSoftClassPath(ClassPaths[ClassIndices[Index]]).TryLoadClass<UItemStaticData>();
+		}
+	}
+
+	Ar << Snapshot.Inventory.EquippedIndex;
+
+	Ar << Snapshot.Health;
+	Ar << Snapshot.Stamina;
+	Ar << Snapshot.MaxMovementSpeed;
+
+	return !Ar.IsError();
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Inventory/InventoryList.h"
+#include "Tasks/Task.h"
+#include "PlayerSnapshotSubsystem.generated.h"
+
+class APawn;
+class APlayerState;
+
+struct FPlayerSnapshot
+{
+	FInventorySnapshot Inventory;
+
+	float Health = 0.f;
+
+	float Stamina = 0.f;
+
+	float MaxMovementSpeed = 0.f;
+};
+
+/**
+ * Keeps a compact versioned binary snapshot of every player's inventory and attributes, in memory across map changes and on disk across server restarts.
+ * Files are written and read on a worker thread, restoring applies a player's whole snapshot in one go on the game thread.
+ */
+UCLASS()
+class ACTIONGAME_API UPlayerSnapshotSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	/** Captures the pawn's inventory and attributes and queues them to be written to disk */
+	void SavePlayer(APawn* Pawn);
+
+	/** Drops the pawn's player snapshot, so the next pawn starts from its defaults */
+	void ForgetPlayer(APawn* Pawn);
+
+	/** Applies the last snapshot saved for the pawn's player, one only on disk is applied once a worker has read it. Returns false if nothing was applied or queued */
+	bool RestorePlayer(APawn* Pawn);
+
+	/** Reads or writes the versioned binary form of a snapshot, returns false if the data is unreadable */
+	static bool SerializeSnapshot(FArchive& Ar, FPlayerSnapshot& Snapshot);
+
+protected:
+	static FString GetPlayerKey(const APlayerState* PlayerState);
+
+	static FString GetSnapshotPath(const FString& PlayerKey);
+
+	/** Decodes the player's snapshot from memory onto the pawn, discarding it if it is unreadable */
+	bool ApplySnapshot(APawn* Pawn, const FString& PlayerKey);
+
+	/** Runs file work for a player on a worker thread after any earlier file work for the same player */
+	void QueueFileTask(const FString& PlayerKey, TUniqueFunction<void()>&& Task);
+
+	/** Serialized snapshots by player, so a restore after a map change never touches the disk */
+	TMap<FString, TArray<uint8>> SnapshotData;
+
+	/** Last file task queued for each player, later reads and writes for the same player wait for it */
+	TMap<FString, UE::Tasks::FTask> PendingWrites;
+};
@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectilePoolSubsystem.h"
+#include "ActionGame.h"
+#include "Actors/Projectile.h"
+#include "Engine/World.h"
+#include "ActionGameStatics.h"
+#include "Subsystems/ProjectileSimulationSubsystem.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Hits"), STAT_ProjectilePoolHits, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Misses"), STAT_ProjectilePoolMisses, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Projectile Pool Evictions"), STAT_ProjectilePoolEvictions, STATGROUP_ActionGame);
+
+static TAutoConsoleVariable<int32> CVarProjectilePoolEnabled(
+	TEXT("ProjectilePool.Enabled"),
+	1,
+	TEXT("Recycle projectile actors instead of spawning and destroying them")
+	TEXT(" 0: Off\n")
+	TEXT(" 1: On\n"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarShowProjectilePool(
+	TEXT("ShowDebugProjectilePool"),
+	0,
+	TEXT("Draws debug info about the projectile pool")
+	TEXT(" 0: Off\n")
+	TEXT(" 1: On\n"),
+	ECVF_Cheat
+);
+
+void UProjectilePoolSubsystem::Deinitialize()
+{
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UProjectilePoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UProjectilePoolSubsystem::IsPoolingEnabled()
+{
+	return CVarProjectilePoolEnabled.GetValueOnGameThread() != 0;
+}
+
+void UProjectilePoolSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Top every pool up to its low watermark, one spawn per pool per frame to spread the cost
+	for (auto& PoolPair : Pools)
+	{
+		FProjectilePool& Pool = PoolPair.Value;
+
+		if (Pool.IdleProjectiles.Num() < Pool.LowWatermark)
+		{
+			if (AProjectile* Projectile = SpawnProjectile(PoolPair.Key, FTransform::Identity, nullptr, nullptr, false))
+			{
+				Pool.IdleProjectiles.Add(Projectile);
+				++Stats.Prewarmed;
+			}
+		}
+	}
+
+	if (CVarShowProjectilePool.GetValueOnGameThread() != 0 && GEngine)
+	{
+		for (const auto& PoolPair : Pools)
+		{
+			GEngine->AddOnScreenDebugMessage(-1, 0, FColor::Blue, FString::Printf(TEXT("Pool %s: %d idle"), *GetNameSafe(PoolPair.Key), PoolPair.Value.IdleProjectiles.Num()));
+		}
+
+		GEngine->AddOnScreenDebugMessage(-1, 0, FColor::Blue, FString::Printf(TEXT("Projectile pool hits: %d misses: %d evictions: %d prewarmed: %d"), Stats.Hits, Stats.Misses, Stats.Evictions, Stats.Prewarmed));
+	}
+}
+
+bool UProjectilePoolSubsystem::IsTickable() const
+{
+	return Pools.Num() > 0;
+}
+
+TStatId UProjectilePoolSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectilePoolSubsystem, STATGROUP_Tickables);
+}
+
+AProjectile* UProjectilePoolSubsystem::AcquireProjectile(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FTransform& Transform, AActor* Owner, APawn* Instigator)
+{
+	if (!IsValid(ProjectileDataClass)) return nullptr;
+
+	if (IsPoolingEnabled())
+	{
+		FProjectilePool& Pool = FindOrAddPool(ProjectileDataClass);
+
+		while (Pool.IdleProjectiles.Num() > 0)
+		{
+			AProjectile* Projectile = Pool.IdleProjectiles.Pop(false);
+
+			if (IsValid(Projectile))
+			{
+				++Stats.Hits;
+				INC_DWORD_STAT(STAT_ProjectilePoolHits);
+
+				Projectile->ActivateProjectile(Transform, Owner, Instigator);
+
+				return Projectile;
+			}
+		}
+
+		++Stats.Misses;
+		INC_DWORD_STAT(STAT_ProjectilePoolMisses);
+	}
+
+	return SpawnProjectile(ProjectileDataClass, Transform, Owner, Instigator, true);
+}
+
+void UProjectilePoolSubsystem::ReleaseProjectile(AProjectile* Projectile)
+{
+	if (!IsValid(Projectile)) return;
+
+	if (!IsPoolingEnabled())
+	{
+		Projectile->Destroy();
+		return;
+	}
+
+	FProjectilePool& Pool = FindOrAddPool(Projectile->ProjectileDataClass);
+
+	if (Pool.IdleProjectiles.Num() >= Pool.HighWatermark)
+	{
+		++Stats.Evictions;
+		INC_DWORD_STAT(STAT_ProjectilePoolEvictions);
+
+		Projectile->Destroy();
+		return;
+	}
+
+	Projectile->DeactivateProjectile();
+
+	Pool.IdleProjectiles.Add(Projectile);
+}
+
+void UProjectilePoolSubsystem::PrewarmProjectiles(TSubclassOf<UProjectileStaticData> ProjectileDataClass, int32 Count)
+{
+	UWorld* World = GetWorld();
+
+	if (!IsValid(ProjectileDataClass) || !World || !World->IsServer()) return;
+
+	FProjectilePool& Pool = FindOrAddPool(ProjectileDataClass);
+
+	const int32 NumToSpawn = FMath::Min(Count, Pool.HighWatermark) - Pool.IdleProjectiles.Num();
+
+	for (int32 i = 0; i < NumToSpawn; ++i)
+	{
+		if (AProjectile* Projectile = SpawnProjectile(ProjectileDataClass, FTransform::Identity, nullptr, nullptr, false))
+		{
+			Pool.IdleProjectiles.Add(Projectile);
+			++Stats.Prewarmed;
+		}
+	}
+}
+
+FProjectilePool& UProjectilePoolSubsystem::FindOrAddPool(TSubclassOf<UProjectileStaticData> ProjectileDataClass)
+{
+	if (FProjectilePool* Pool = Pools.Find(ProjectileDataClass))
+	{
+		return *Pool;
+	}
+
+	FProjectilePool& Pool = Pools.Add(ProjectileDataClass);
+
+	if (const UProjectileStaticData* ProjectileData = GetDefault<UProjectileStaticData>(ProjectileDataClass))
+	{
+		Pool.HighWatermark = FMath::Max(ProjectileData->PoolHighWatermark, 0);
+		Pool.LowWatermark = FMath::Clamp(ProjectileData->PoolLowWatermark, 0, Pool.HighWatermark);
+	}
+
+	if (UProjectileSimulationSubsystem* ProjectileSimulation = GetWorld()->GetSubsystem<UProjectileSimulationSubsystem>())
+	{
+		ProjectileSimulation->RequestProjectileAssets(ProjectileDataClass);
+	}
+
+	return Pool;
+}
+
+AProjectile* UProjectilePoolSubsystem::SpawnProjectile(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FTransform& Transform, AActor* Owner, APawn* Instigator, bool bActive)
+{
+	UWorld* World = GetWorld();
+
+	if (World && World->IsServer())
+	{
+		if (AProjectile* Projectile = World->SpawnActorDeferred<AProjectile>(AProjectile::StaticClass(), Transform, Owner, Instigator, ESpawnActorCollisionHandlingMethod::AlwaysSpawn))
+		{
+			Projectile->ProjectileDataClass = ProjectileDataClass;
+			Projectile->bIsActive = bActive;
+			Projectile->FinishSpawning(Transform);
+
+			if (!bActive)
+			{
+				Projectile->SetNetDormancy(DORM_DormantAll);
+			}
+
+			return Projectile;
+		}
+	}
+
+	return nullptr;
+}
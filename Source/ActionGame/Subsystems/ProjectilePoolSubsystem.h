@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ActionGameTypes.h"
+#include "ProjectilePoolSubsystem.generated.h"
+
+class AProjectile;
+
+USTRUCT(BlueprintType)
+struct FProjectilePoolStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Hits = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Misses = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Evictions = 0;
+
+	UPROPERTY(BlueprintReadOnly)
+	int32 Prewarmed = 0;
+};
+
+USTRUCT()
+struct FProjectilePool
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AProjectile>> IdleProjectiles;
+
+	int32 LowWatermark = 0;
+
+	int32 HighWatermark = 0;
+};
+
+/**
+ * Server side pool of AProjectile actors, one pool per projectile data class.
+ * Idle projectiles are hidden, have collision disabled and are net dormant until reused.
+ */
+UCLASS()
+class ACTIONGAME_API UProjectilePoolSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	AProjectile* AcquireProjectile(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FTransform& Transform, AActor* Owner, APawn* Instigator);
+
+	void ReleaseProjectile(AProjectile* Projectile);
+
+	UFUNCTION(BlueprintCallable)
+	void PrewarmProjectiles(TSubclassOf<UProjectileStaticData> ProjectileDataClass, int32 Count);
+
+	UFUNCTION(BlueprintPure)
+	FProjectilePoolStats GetPoolStats() const { return Stats; }
+
+	static bool IsPoolingEnabled();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	FProjectilePool& FindOrAddPool(TSubclassOf<UProjectileStaticData> ProjectileDataClass);
+
+	AProjectile* SpawnProjectile(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FTransform& Transform, AActor* Owner, APawn* Instigator, bool bActive);
+
+	UPROPERTY()
+	TMap<TSubclassOf<UProjectileStaticData>, FProjectilePool> Pools;
+
+	FProjectilePoolStats Stats;
+};
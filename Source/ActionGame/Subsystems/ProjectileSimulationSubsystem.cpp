@@ -0,0 +1,662 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectileSimulationSubsystem.h"
+#include "ActionGame.h"
+#include "ActionGameStatics.h"
+#include "DrawDebugHelpers.h"
+#include "Actors/VirtualProjectileReplicator.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Subsystems/CosmeticEffectsSubsystem.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StreamableManager.h"
+#include "NiagaraSystem.h"
+#include "Sound/SoundBase.h"
+
+DECLARE_CYCLE_STAT(TEXT("Batched Projectile Integrate"), STAT_BatchedProjectileIntegrate, STATGROUP_ActionGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Projectiles"), STAT_BatchedProjectiles, STATGROUP_ActionGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Projectile Impacts"), STAT_BatchedProjectileImpacts, STATGROUP_ActionGame);
+
+static TAutoConsoleVariable<int32> CVarShowBatchedProjectiles(
+	TEXT("ShowDebugBatchedProjectiles"),
+	0,
+	TEXT("Draws debug info about batched projectiles")
+	TEXT(" 0: Off\n")
+	TEXT(" 1: On\n"),
+	ECVF_Cheat
+);
+
+int32 FBatchedProjectileState::Add(const FVector& Location, const FVector& Velocity, float InGravityZ, float InMaxSpeed, float InLifetime, float InFixedTimestep, int32 InMaxSubsteps)
+{
+	PositionX.Add(Location.X);
+	PositionY.Add(Location.Y);
+	PositionZ.Add(Location.Z);
+
+	PreviousX.Add(Location.X);
+	PreviousY.Add(Location.Y);
+	PreviousZ.Add(Location.Z);
+
+	LastStepX.Add(Location.X);
+	LastStepY.Add(Location.Y);
+	LastStepZ.Add(Location.Z);
+
+	VelocityX.Add(Velocity.X);
+	VelocityY.Add(Velocity.Y);
+	VelocityZ.Add(Velocity.Z);
+
+	GravityZ.Add(InGravityZ);
+	MaxSpeed.Add(InMaxSpeed);
+
+	FixedTimestep.Add(InFixedTimestep);
+	StepAccumulator.Add(0.f);
+	MaxSubsteps.Add(InMaxSubsteps);
+
+	return TimeRemaining.Add(InLifetime);
+}
+
+void FBatchedProjectileState::RemoveAtSwap(int32 Index)
+{
+	PositionX.RemoveAtSwap(Index, 1, false);
+	PositionY.RemoveAtSwap(Index, 1, false);
+	PositionZ.RemoveAtSwap(Index, 1, false);
+
+	PreviousX.RemoveAtSwap(Index, 1, false);
+	PreviousY.RemoveAtSwap(Index, 1, false);
+	PreviousZ.RemoveAtSwap(Index, 1, false);
+
+	LastStepX.RemoveAtSwap(Index, 1, false);
+	LastStepY.RemoveAtSwap(Index, 1, false);
+	LastStepZ.RemoveAtSwap(Index, 1, false);
+
+	VelocityX.RemoveAtSwap(Index, 1, false);
+	VelocityY.RemoveAtSwap(Index, 1, false);
+	VelocityZ.RemoveAtSwap(Index, 1, false);
+
+	GravityZ.RemoveAtSwap(Index, 1, false);
+	MaxSpeed.RemoveAtSwap(Index, 1, false);
+	TimeRemaining.RemoveAtSwap(Index, 1, false);
+
+	FixedTimestep.RemoveAtSwap(Index, 1, false);
+	StepAccumulator.RemoveAtSwap(Index, 1, false);
+	MaxSubsteps.RemoveAtSwap(Index, 1, false);
+}
+
+void FBatchedProjectileState::Reset()
+{
+	PositionX.Reset();
+	PositionY.Reset();
+	PositionZ.Reset();
+
+	PreviousX.Reset();
+	PreviousY.Reset();
+	PreviousZ.Reset();
+
+	LastStepX.Reset();
+	LastStepY.Reset();
+	LastStepZ.Reset();
+
+	VelocityX.Reset();
+	VelocityY.Reset();
+	VelocityZ.Reset();
+
+	GravityZ.Reset();
+	MaxSpeed.Reset();
+	TimeRemaining.Reset();
+
+	FixedTimestep.Reset();
+	StepAccumulator.Reset();
+	MaxSubsteps.Reset();
+}
+
+FVector FBatchedProjectileState::GetInterpolatedPosition(int32 Index) const
+{
+	const float Alpha = FixedTimestep[Index] > 0.f ? StepAccumulator[Index] / FixedTimestep[Index] : 1.f;
+
+	return FMath::Lerp(FVector(LastStepX[Index], LastStepY[Index], LastStepZ[Index]), GetPosition(Index), Alpha);
+}
+
+void UProjectileSimulationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SweepDelegate.BindUObject(this, &UProjectileSimulationSubsystem::OnSweepCompleted);
+}
+
+void UProjectileSimulationSubsystem::Deinitialize()
+{
+	SweepDelegate.Unbind();
+
+	State.Reset();
+	Infos.Reset();
+	IdToIndex.Reset();
+	PendingImpacts.Reset();
+	SweepRequests.Reset();
+	VisualComponents.Reset();
+	VisualTransforms.Reset();
+	AssetHandles.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UProjectileSimulationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UProjectileSimulationSubsystem::IsTickable() const
+{
+	return State.Num() > 0 || PendingImpacts.Num() > 0 || bVisualsDirty || (Replicator && Replicator->HasPendingRecords());
+}
+
+TStatId UProjectileSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSimulationSubsystem, STATGROUP_Tickables);
+}
+
+uint32 UProjectileSimulationSubsystem::LaunchProjectile(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FTransform& Transform, AActor* Owner, APawn* Instigator)
+{
+	const UProjectileStaticData* ProjectileData = IsValid(ProjectileDataClass) ? GetDefault<UProjectileStaticData>(ProjectileDataClass) : nullptr;
+
+	if (!ProjectileData) return 0;
+
+	const FVector Direction = Transform.GetRotation().GetForwardVector();
+
+	const int32 Index = AddProjectile(ProjectileDataClass, Transform.GetLocation(), ProjectileData->InitialSpeed * Direction, ProjectileData->MaxLifetime);
+
+	if (Index == INDEX_NONE) return 0;
+
+	FBatchedProjectileInfo& Info = Infos[Index];
+	Info.Owner = Owner;
+	Info.Instigator = Instigator;
+
+	if (ProjectileData->SimulationMode == EProjectileSimulationMode::Virtual)
+	{
+		if (AVirtualProjectileReplicator* ProjectileReplicator = GetOrSpawnReplicator())
+		{
+			Info.Seed = static_cast<uint16>(FMath::Rand());
+			Info.bReplicated = true;
+
+			ProjectileReplicator->AddRecord(Info.ProjectileId, ProjectileDataClass, Transform.GetLocation(), Direction, Info.Seed);
+		}
+	}
+
+	return Info.ProjectileId;
+}
+
+uint32 UProjectileSimulationSubsystem::LaunchCosmeticProjectile(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FVector& Origin, const FVector& Direction, float ElapsedTime, uint16 Seed)
+{
+	UWorld* World = GetWorld();
+	const UProjectileStaticData* ProjectileData = IsValid(ProjectileDataClass) ? GetDefault<UProjectileStaticData>(ProjectileDataClass) : nullptr;
+
+	if (!World || !ProjectileData || ElapsedTime >= ProjectileData->MaxLifetime) return 0;
+
+	// Fast forward along the ballistic path to where the server projectile is by now
+	const float GravityZ = World->GetGravityZ() * ProjectileData->GravityMultiplyer;
+	const FVector InitialVelocity = ProjectileData->InitialSpeed * Direction.GetSafeNormal();
+	const FVector Location = Origin + InitialVelocity * ElapsedTime + FVector(0.f, 0.f, 0.5f * GravityZ * ElapsedTime * ElapsedTime);
+	const FVector Velocity = InitialVelocity + FVector(0.f, 0.f, GravityZ * ElapsedTime);
+
+	const int32 Index = AddProjectile(ProjectileDataClass, Location, Velocity, ProjectileData->MaxLifetime - ElapsedTime);
+
+	if (Index == INDEX_NONE) return 0;
+
+	FBatchedProjectileInfo& Info = Infos[Index];
+	Info.Seed = Seed;
+	Info.bCosmetic = true;
+
+	return Info.ProjectileId;
+}
+
+void UProjectileSimulationSubsystem::StopCosmeticProjectile(uint32 ProjectileId, const FVector& ImpactLocation, bool bPlayStopEffects)
+{
+	if (const int32* Index = IdToIndex.Find(ProjectileId))
+	{
+		if (bPlayStopEffects)
+		{
+			PlayStopEffects(Infos[*Index].ProjectileDataClass, ImpactLocation);
+		}
+
+		RemoveProjectileAt(*Index);
+	}
+}
+
+void UProjectileSimulationSubsystem::RegisterReplicator(AVirtualProjectileReplicator* InReplicator)
+{
+	Replicator = InReplicator;
+}
+
+void UProjectileSimulationSubsystem::RequestProjectileAssets(TSubclassOf<UProjectileStaticData> ProjectileDataClass)
+{
+	if (!IsValid(ProjectileDataClass) || AssetHandles.Contains(ProjectileDataClass)) return;
+
+	AssetHandles.Add(ProjectileDataClass, UActionGameStatics::RequestStaticDataAssets(ProjectileDataClass));
+}
+
+int32 UProjectileSimulationSubsystem::AddProjectile(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FVector& Location, const FVector& Velocity, float Lifetime)
+{
+	UWorld* World = GetWorld();
+
+	if (!World) return INDEX_NONE;
+
+	RequestProjectileAssets(ProjectileDataClass);
+
+	const UProjectileStaticData* ProjectileData = GetDefault<UProjectileStaticData>(ProjectileDataClass);
+	const float GravityZ = World->GetGravityZ() * ProjectileData->GravityMultiplyer;
+
+	const float FixedTimestep = ProjectileData->bUseFixedTimestep ? FMath::Max(ProjectileData->FixedTimestep, 0.001f) : 0.f;
+
+	const int32 Index = State.Add(Location, Velocity, GravityZ, ProjectileData->MaxSpeed, Lifetime, FixedTimestep, FMath::Max(ProjectileData->MaxSubsteps, 1));
+
+	FBatchedProjectileInfo& Info = Infos.AddDefaulted_GetRef();
+	Info.ProjectileDataClass = ProjectileDataClass;
+	Info.ProjectileId = NextProjectileId++;
+
+	check(Infos.Num() == State.Num());
+
+	IdToIndex.Add(Info.ProjectileId, Index);
+
+	return Index;
+}
+
+AVirtualProjectileReplicator* UProjectileSimulationSubsystem::GetOrSpawnReplicator()
+{
+	UWorld* World = GetWorld();
+
+	if (!Replicator && World && World->GetNetMode() != NM_Standalone && World->GetNetMode() != NM_Client)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		Replicator = World->SpawnActor<AVirtualProjectileReplicator>(SpawnParams);
+	}
+
+	return Replicator;
+}
+
+void UProjectileSimulationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ProcessImpacts();
+
+	// Expire before integrating so the per frame step scratch stays aligned with the state arrays until the sweeps are issued
+	RemoveExpired();
+
+	Integrate(DeltaTime);
+
+	IssueSweeps();
+
+	if (Replicator && Replicator->HasAuthority())
+	{
+		Replicator->PruneRecords();
+	}
+
+	UpdateVisuals();
+
+	SET_DWORD_STAT(STAT_BatchedProjectiles, State.Num());
+
+	if (CVarShowBatchedProjectiles.GetValueOnGameThread() != 0)
+	{
+		for (int32 i = 0; i < State.Num(); ++i)
+		{
+			FVector SegmentStart = State.GetPreviousPosition(i);
+
+			for (int32 Step = 0; Step < StepCounts[i]; ++Step)
+			{
+				const FVector& SegmentEnd = PathPoints[PathStarts[i] + Step];
+
+				DrawDebugLine(GetWorld(), SegmentStart, SegmentEnd, FColor::Orange, false, 2.f, 0, 1);
+				DrawDebugPoint(GetWorld(), SegmentEnd, 4.f, FColor::Yellow, false, 2.f);
+
+				SegmentStart = SegmentEnd;
+			}
+		}
+	}
+}
+
+void UProjectileSimulationSubsystem::ProcessImpacts()
+{
+	// Earliest step first, later hits of a projectile that already impacted are skipped below
+	PendingImpacts.StableSort([](const FBatchedProjectileImpact& A, const FBatchedProjectileImpact& B) { return A.Step < B.Step; });
+
+	// Removals swap entries around, so always resolve the index from the id
+	for (const FBatchedProjectileImpact& Impact : PendingImpacts)
+	{
+		const int32* Index = IdToIndex.Find(Impact.ProjectileId);
+
+		if (!Index) continue;
+
+		const FBatchedProjectileInfo& Info = Infos[*Index];
+
+		if (const UProjectileStaticData* ProjectileData = IsValid(Info.ProjectileDataClass) ? GetDefault<UProjectileStaticData>(Info.ProjectileDataClass) : nullptr)
+		{
+			UActionGameStatics::ApplyRadialDamage(this, Info.Owner.Get(), Impact.HitResult.Location,
+				ProjectileData->DamageRadius,
+				ProjectileData->BaseDamage,
+				ProjectileData->Effects,
+				ProjectileData->RadialDamageQueryTypes,
+				ProjectileData->RadialDamageTraceType
+			);
+		}
+
+		if (Info.bReplicated && Replicator)
+		{
+			Replicator->OnProjectileImpact(Info.ProjectileId, Impact.HitResult.Location);
+		}
+
+		PlayStopEffects(Info.ProjectileDataClass, Impact.HitResult.Location);
+
+		INC_DWORD_STAT(STAT_BatchedProjectileImpacts);
+
+		RemoveProjectileAt(*Index);
+	}
+
+	PendingImpacts.Reset();
+}
+
+void UProjectileSimulationSubsystem::Integrate(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_BatchedProjectileIntegrate);
+
+	const int32 Num = State.Num();
+
+	StepCounts.SetNumUninitialized(Num);
+	StepDeltas.SetNumUninitialized(Num);
+	PathStarts.SetNumUninitialized(Num);
+
+	// Decide how many steps each projectile takes this frame, variable step projectiles always take exactly one
+	int32 MaxStepCount = 0;
+	int32 NumPathPoints = 0;
+
+	for (int32 i = 0; i < Num; ++i)
+	{
+		const float FixedStep = State.FixedTimestep[i];
+
+		if (FixedStep > 0.f)
+		{
+			float& Accumulator = State.StepAccumulator[i];
+			Accumulator += DeltaTime;
+
+			const int32 Steps = FMath::Min(FMath::FloorToInt(Accumulator / FixedStep), State.MaxSubsteps[i]);
+
+			// Drop whatever did not fit in MaxSubsteps rather than carrying it into the next frame
+			Accumulator = FMath::Min(Accumulator - Steps * FixedStep, FixedStep);
+
+			StepCounts[i] = Steps;
+			StepDeltas[i] = FixedStep;
+		}
+		else
+		{
+			StepCounts[i] = 1;
+			StepDeltas[i] = DeltaTime;
+		}
+
+		PathStarts[i] = NumPathPoints;
+		NumPathPoints += StepCounts[i];
+		MaxStepCount = FMath::Max(MaxStepCount, StepCounts[i]);
+	}
+
+	PathPoints.SetNumUninitialized(NumPathPoints);
+
+	float* RESTRICT PX = State.PositionX.GetData();
+	float* RESTRICT PY = State.PositionY.GetData();
+	float* RESTRICT PZ = State.PositionZ.GetData();
+
+	float* RESTRICT OX = State.PreviousX.GetData();
+	float* RESTRICT OY = State.PreviousY.GetData();
+	float* RESTRICT OZ = State.PreviousZ.GetData();
+
+	float* RESTRICT LX = State.LastStepX.GetData();
+	float* RESTRICT LY = State.LastStepY.GetData();
+	float* RESTRICT LZ = State.LastStepZ.GetData();
+
+	float* RESTRICT VX = State.VelocityX.GetData();
+	float* RESTRICT VY = State.VelocityY.GetData();
+	float* RESTRICT VZ = State.VelocityZ.GetData();
+
+	const float* RESTRICT GZ = State.GravityZ.GetData();
+	const float* RESTRICT MS = State.MaxSpeed.GetData();
+	float* RESTRICT TR = State.TimeRemaining.GetData();
+
+	const int32* RESTRICT SC = StepCounts.GetData();
+	const float* RESTRICT SD = StepDeltas.GetData();
+
+	for (int32 i = 0; i < Num; ++i)
+	{
+		OX[i] = PX[i];
+		OY[i] = PY[i];
+		OZ[i] = PZ[i];
+	}
+
+	for (int32 Step = 0; Step < MaxStepCount; ++Step)
+	{
+		// Branch free so the compiler can vectorize it, mirrors UProjectileMovementComponent::ComputeMoveDelta and LimitVelocity.
+		// Projectiles that are out of steps integrate with a zero delta, which leaves them untouched.
+		for (int32 i = 0; i < Num; ++i)
+		{
+			const bool bStep = Step < SC[i];
+			const float Dt = bStep ? SD[i] : 0.f;
+
+			LX[i] = bStep ? PX[i] : LX[i];
+			LY[i] = bStep ? PY[i] : LY[i];
+			LZ[i] = bStep ? PZ[i] : LZ[i];
+
+			const float NewVZ = VZ[i] + GZ[i] * Dt;
+
+			PX[i] += VX[i] * Dt;
+			PY[i] += VY[i] * Dt;
+			PZ[i] += 0.5f * (VZ[i] + NewVZ) * Dt;
+
+			VZ[i] = NewVZ;
+
+			const float SpeedSq = VX[i] * VX[i] + VY[i] * VY[i] + VZ[i] * VZ[i];
+			const float MaxSpeedSq = MS[i] * MS[i];
+			const float Scale = (MS[i] > 0.f && SpeedSq > MaxSpeedSq) ? MS[i] / FMath::Sqrt(SpeedSq) : 1.f;
+
+			VX[i] *= Scale;
+			VY[i] *= Scale;
+			VZ[i] *= Scale;
+
+			TR[i] -= Dt;
+		}
+
+		for (int32 i = 0; i < Num; ++i)
+		{
+			if (Step < SC[i])
+			{
+				PathPoints[PathStarts[i] + Step] = FVector(PX[i], PY[i], PZ[i]);
+			}
+		}
+	}
+}
+
+void UProjectileSimulationSubsystem::RemoveExpired()
+{
+	for (int32 i = State.Num() - 1; i >= 0; --i)
+	{
+		if (State.TimeRemaining[i] <= 0.f)
+		{
+			if (Infos[i].bReplicated && Replicator)
+			{
+				Replicator->OnProjectileExpired(Infos[i].ProjectileId);
+			}
+
+			RemoveProjectileAt(i);
+		}
+	}
+}
+
+void UProjectileSimulationSubsystem::IssueSweeps()
+{
+	UWorld* World = GetWorld();
+
+	SweepRequests.Reset();
+
+	if (!World) return;
+
+	static const FName ProjectileProfileName = TEXT("Projectile");
+	static const FName BatchedProjectileSweepName = TEXT("BatchedProjectileSweep");
+
+	for (int32 i = 0; i < State.Num(); ++i)
+	{
+		const FBatchedProjectileInfo& Info = Infos[i];
+
+		if (Info.bCosmetic || StepCounts[i] == 0) continue;
+
+		const UProjectileStaticData* ProjectileData = GetDefault<UProjectileStaticData>(Info.ProjectileDataClass);
+
+		FCollisionQueryParams QueryParams(BatchedProjectileSweepName, false);
+		QueryParams.AddIgnoredActor(Info.Owner.Get());
+		QueryParams.AddIgnoredActor(Info.Instigator.Get());
+
+		const FCollisionShape Shape = FCollisionShape::MakeSphere(ProjectileData->CollisionRadius);
+
+		// One sweep per integration step so fast fixed step projectiles follow the arc instead of cutting across it
+		FVector SegmentStart = State.GetPreviousPosition(i);
+
+		for (int32 Step = 0; Step < StepCounts[i]; ++Step)
+		{
+			const FVector& SegmentEnd = PathPoints[PathStarts[i] + Step];
+
+			FBatchedProjectileSweep& Sweep = SweepRequests.AddDefaulted_GetRef();
+			Sweep.ProjectileId = Info.ProjectileId;
+			Sweep.Step = Step;
+
+			World->AsyncSweepByProfile(EAsyncTraceType::Single, SegmentStart, SegmentEnd, FQuat::Identity, ProjectileProfileName,
+				Shape, QueryParams, &SweepDelegate, SweepRequests.Num() - 1);
+
+			SegmentStart = SegmentEnd;
+		}
+	}
+}
+
+void UProjectileSimulationSubsystem::RemoveProjectileAt(int32 Index)
+{
+	const int32 LastIndex = State.Num() - 1;
+
+	IdToIndex.Remove(Infos[Index].ProjectileId);
+
+	State.RemoveAtSwap(Index);
+	Infos.RemoveAtSwap(Index, 1, false);
+
+	if (Index != LastIndex)
+	{
+		IdToIndex.Add(Infos[Index].ProjectileId, Index);
+	}
+
+	bVisualsDirty = true;
+}
+
+void UProjectileSimulationSubsystem::UpdateVisuals()
+{
+	bVisualsDirty = false;
+
+	UWorld* World = GetWorld();
+
+	if (!World || World->GetNetMode() == NM_DedicatedServer) return;
+
+	for (auto& TransformsPair : VisualTransforms)
+	{
+		TransformsPair.Value.Reset();
+	}
+
+	for (int32 i = 0; i < State.Num(); ++i)
+	{
+		const FBatchedProjectileInfo& Info = Infos[i];
+
+		FRotator Rotation = State.GetVelocity(i).Rotation();
+		Rotation.Roll = Info.Seed * (360.f / MAX_uint16);
+
+		VisualTransforms.FindOrAdd(Info.ProjectileDataClass).Emplace(Rotation, State.GetInterpolatedPosition(i));
+	}
+
+	for (const auto& TransformsPair : VisualTransforms)
+	{
+		UInstancedStaticMeshComponent* VisualComponent = FindOrAddVisualComponent(TransformsPair.Key);
+
+		if (!VisualComponent) continue;
+
+		const TArray<FTransform>& Transforms = TransformsPair.Value;
+		const int32 NumInstances = VisualComponent->GetInstanceCount();
+
+		if (NumInstances > Transforms.Num())
+		{
+			VisualComponent->ClearInstances();
+			VisualComponent->AddInstances(Transforms, false, true);
+		}
+		else
+		{
+			if (NumInstances < Transforms.Num())
+			{
+				VisualComponent->AddInstances(TArray<FTransform>(Transforms.GetData() + NumInstances, Transforms.Num() - NumInstances), false, true);
+			}
+
+			if (Transforms.Num() > 0)
+			{
+				VisualComponent->BatchUpdateInstancesTransforms(0, Transforms, true, true, true);
+			}
+		}
+	}
+}
+
+UInstancedStaticMeshComponent* UProjectileSimulationSubsystem::FindOrAddVisualComponent(TSubclassOf<UProjectileStaticData> ProjectileDataClass)
+{
+	if (TObjectPtr<UInstancedStaticMeshComponent>* VisualComponent = VisualComponents.Find(ProjectileDataClass))
+	{
+		return *VisualComponent;
+	}
+
+	const UProjectileStaticData* ProjectileData = GetDefault<UProjectileStaticData>(ProjectileDataClass);
+
+	// Not drawn until the mesh has streamed in, UpdateVisuals asks again next frame
+	UStaticMesh* StaticMesh = ProjectileData->StaticMesh.Get();
+
+	if (!StaticMesh) return nullptr;
+
+	if (!VisualsOwner)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		VisualsOwner = GetWorld()->SpawnActor<AActor>(SpawnParams);
+	}
+
+	UInstancedStaticMeshComponent* VisualComponent = NewObject<UInstancedStaticMeshComponent>(VisualsOwner);
+	VisualComponent->SetMobility(EComponentMobility::Movable);
+	VisualComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	VisualComponent->SetStaticMesh(StaticMesh);
+	VisualComponent->RegisterComponent();
+
+	VisualComponents.Add(ProjectileDataClass, VisualComponent);
+
+	return VisualComponent;
+}
+
+void UProjectileSimulationSubsystem::PlayStopEffects(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FVector& Location) const
+{
+	UCosmeticEffectsSubsystem* CosmeticEffects = UCosmeticEffectsSubsystem::Get(this);
+	const UProjectileStaticData* ProjectileData = IsValid(ProjectileDataClass) ? GetDefault<UProjectileStaticData>(ProjectileDataClass) : nullptr;
+
+	if (!CosmeticEffects || !ProjectileData) return;
+
+	// Both stay loaded through AssetHandles, a projectile that stops before they stream in plays nothing instead of hitching
+	CosmeticEffects->PlaySoundAtLocation(ProjectileData->OnStopSFX.Get(), Location);
+
+	CosmeticEffects->SpawnSystemAtLocation(ProjectileData->OnStopVFX.Get(), Location);
+}
+
+void UProjectileSimulationSubsystem::OnSweepCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	if (!SweepRequests.IsValidIndex(Datum.UserData)) return;
+
+	if (const FHitResult* BlockingHit = FHitResult::GetFirstBlockingHit(Datum.OutHits))
+	{
+		const FBatchedProjectileSweep& Sweep = SweepRequests[Datum.UserData];
+
+		FBatchedProjectileImpact& Impact = PendingImpacts.AddDefaulted_GetRef();
+		Impact.ProjectileId = Sweep.ProjectileId;
+		Impact.Step = Sweep.Step;
+		Impact.HitResult = *BlockingHit;
+	}
+}
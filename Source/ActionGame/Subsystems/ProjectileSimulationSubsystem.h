@@ -0,0 +1,192 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/World.h"
+#include "ActionGameTypes.h"
+#include "ProjectileSimulationSubsystem.generated.h"
+
+class AVirtualProjectileReplicator;
+class UInstancedStaticMeshComponent;
+struct FStreamableHandle;
+
+/** Hot per-projectile state, one array per component so the integration loop stays contiguous */
+struct FBatchedProjectileState
+{
+	TArray<float> PositionX;
+	TArray<float> PositionY;
+	TArray<float> PositionZ;
+
+	TArray<float> PreviousX;
+	TArray<float> PreviousY;
+	TArray<float> PreviousZ;
+
+	// Position before the last integration step, used to interpolate fixed step visuals
+	TArray<float> LastStepX;
+	TArray<float> LastStepY;
+	TArray<float> LastStepZ;
+
+	TArray<float> VelocityX;
+	TArray<float> VelocityY;
+	TArray<float> VelocityZ;
+
+	TArray<float> GravityZ;
+	TArray<float> MaxSpeed;
+	TArray<float> TimeRemaining;
+
+	// Zero for projectiles that step with the frame
+	TArray<float> FixedTimestep;
+	TArray<float> StepAccumulator;
+	TArray<int32> MaxSubsteps;
+
+	int32 Num() const { return PositionX.Num(); }
+
+	int32 Add(const FVector& Location, const FVector& Velocity, float InGravityZ, float InMaxSpeed, float InLifetime, float InFixedTimestep, int32 InMaxSubsteps);
+
+	void RemoveAtSwap(int32 Index);
+
+	void Reset();
+
+	FVector GetPosition(int32 Index) const { return FVector(PositionX[Index], PositionY[Index], PositionZ[Index]); }
+
+	FVector GetPreviousPosition(int32 Index) const { return FVector(PreviousX[Index], PreviousY[Index], PreviousZ[Index]); }
+
+	FVector GetVelocity(int32 Index) const { return FVector(VelocityX[Index], VelocityY[Index], VelocityZ[Index]); }
+
+	/** Position between the last two fixed steps matching the time left in the accumulator */
+	FVector GetInterpolatedPosition(int32 Index) const;
+};
+
+/** Cold per-projectile data, only touched on launch and impact */
+struct FBatchedProjectileInfo
+{
+	TSubclassOf<UProjectileStaticData> ProjectileDataClass;
+
+	TWeakObjectPtr<AActor> Owner;
+
+	TWeakObjectPtr<APawn> Instigator;
+
+	uint32 ProjectileId = 0;
+
+	uint16 Seed = 0;
+
+	// Server projectile mirrored to clients through AVirtualProjectileReplicator
+	bool bReplicated = false;
+
+	// Client copy of a replicated projectile, never swept and never applies damage
+	bool bCosmetic = false;
+};
+
+struct FBatchedProjectileSweep
+{
+	uint32 ProjectileId = 0;
+
+	int32 Step = 0;
+};
+
+struct FBatchedProjectileImpact
+{
+	uint32 ProjectileId = 0;
+
+	int32 Step = 0;
+
+	FHitResult HitResult;
+};
+
+/**
+ * Simulates actorless projectiles in one structure of arrays update per frame.
+ * Every in-flight projectile is swept asynchronously against the world once per integration step and
+ * the earliest impact is resolved at the start of the next frame before the next integration.
+ * Projectile data can opt into fixed step integration, which substeps and interpolates the visuals.
+ * Virtual projectiles are mirrored to clients as cosmetic copies and drawn with instanced static meshes.
+ */
+UCLASS()
+class ACTIONGAME_API UProjectileSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	uint32 LaunchProjectile(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FTransform& Transform, AActor* Owner, APawn* Instigator);
+
+	uint32 LaunchCosmeticProjectile(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FVector& Origin, const FVector& Direction, float ElapsedTime, uint16 Seed);
+
+	void StopCosmeticProjectile(uint32 ProjectileId, const FVector& ImpactLocation, bool bPlayStopEffects);
+
+	void RegisterReplicator(AVirtualProjectileReplicator* InReplicator);
+
+	/** Starts streaming a projectile data's content and keeps it loaded for the world's lifetime, on every net mode */
+	void RequestProjectileAssets(TSubclassOf<UProjectileStaticData> ProjectileDataClass);
+
+	UFUNCTION(BlueprintPure)
+	int32 GetNumProjectiles() const { return State.Num(); }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	void ProcessImpacts();
+
+	void Integrate(float DeltaTime);
+
+	void RemoveExpired();
+
+	void IssueSweeps();
+
+	void RemoveProjectileAt(int32 Index);
+
+	int32 AddProjectile(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FVector& Location, const FVector& Velocity, float Lifetime);
+
+	AVirtualProjectileReplicator* GetOrSpawnReplicator();
+
+	void UpdateVisuals();
+
+	UInstancedStaticMeshComponent* FindOrAddVisualComponent(TSubclassOf<UProjectileStaticData> ProjectileDataClass);
+
+	void PlayStopEffects(TSubclassOf<UProjectileStaticData> ProjectileDataClass, const FVector& Location) const;
+
+	void OnSweepCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	FBatchedProjectileState State;
+
+	TArray<FBatchedProjectileInfo> Infos;
+
+	TMap<uint32, int32> IdToIndex;
+
+	TArray<FBatchedProjectileImpact> PendingImpacts;
+
+	// Per frame scratch written by Integrate and read by IssueSweeps
+	TArray<int32> StepCounts;
+	TArray<float> StepDeltas;
+	TArray<int32> PathStarts;
+	TArray<FVector> PathPoints;
+
+	// Kept until the next IssueSweeps so completed sweeps can be mapped back to their projectile and step
+	TArray<FBatchedProjectileSweep> SweepRequests;
+
+	FTraceDelegate SweepDelegate;
+
+	UPROPERTY()
+	TObjectPtr<AVirtualProjectileReplicator> Replicator = nullptr;
+
+	UPROPERTY()
+	TObjectPtr<AActor> VisualsOwner = nullptr;
+
+	UPROPERTY()
+	TMap<TSubclassOf<UProjectileStaticData>, TObjectPtr<UInstancedStaticMeshComponent>> VisualComponents;
+
+	TMap<TSubclassOf<UProjectileStaticData>, TArray<FTransform>> VisualTransforms;
+
+	TMap<TSubclassOf<UProjectileStaticData>, TSharedPtr<FStreamableHandle>> AssetHandles;
+
+	bool bVisualsDirty = false;
+
+	uint32 NextProjectileId = 1;
+};
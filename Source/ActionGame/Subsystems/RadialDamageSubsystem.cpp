@@ -0,0 +1,235 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RadialDamageSubsystem.h"
+#include "ActionGame.h"
+#include "ActionGameStatics.h"
+#include "Engine/World.h"
+#include "GameplayEffect.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Radial Damage Queued"), STAT_RadialDamageQueued, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Radial Damage Traces Resolved"), STAT_RadialDamageResolved, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Radial Damage Targets Applied"), STAT_RadialDamageApplied, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Radial Damage Hits Coalesced"), STAT_RadialDamageCoalesced, STATGROUP_ActionGame);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Radial Damage Specs Applied"), STAT_RadialDamageSpecsApplied, STATGROUP_ActionGame);
+
+static TAutoConsoleVariable<int32> CVarRadialDamageAsync(
+	TEXT("RadialDamage.Async"),
+	1,
+	TEXT("Resolve radial damage with async overlaps and traces, applied the following frames")
+	TEXT(" 0: Sync\n")
+	TEXT(" 1: Async\n"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<int32> CVarRadialDamageCoalesce(
+	TEXT("RadialDamage.Coalesce"),
+	1,
+	TEXT("Sum instant radial damage per target, effect and causer and apply one spec per frame")
+	TEXT(" 0: Off\n")
+	TEXT(" 1: On\n"),
+	ECVF_Default
+);
+
+void URadialDamageSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	OverlapDelegate.BindUObject(this, &URadialDamageSubsystem::OnOverlapCompleted);
+	TraceDelegate.BindUObject(this, &URadialDamageSubsystem::OnTraceCompleted);
+}
+
+void URadialDamageSubsystem::Deinitialize()
+{
+	OverlapDelegate.Unbind();
+	TraceDelegate.Unbind();
+
+	Explosions.Reset();
+	PendingTargets.Reset();
+	ResolvedTargets.Reset();
+	AccumulatedDamage.Reset();
+
+	Super::Deinitialize();
+}
+
+bool URadialDamageSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool URadialDamageSubsystem::IsAsyncEnabled()
+{
+	return CVarRadialDamageAsync.GetValueOnGameThread() != 0;
+}
+
+bool URadialDamageSubsystem::IsCoalescingEnabled()
+{
+	return CVarRadialDamageCoalesce.GetValueOnGameThread() != 0;
+}
+
+bool URadialDamageSubsystem::CanCoalesce(TSubclassOf<UGameplayEffect> DamageEffect)
+{
+	const UGameplayEffect* DamageEffectCDO = DamageEffect ? DamageEffect->GetDefaultObject<UGameplayEffect>() : nullptr;
+
+	return IsCoalescingEnabled() && DamageEffectCDO && DamageEffectCDO->DurationPolicy == EGameplayEffectDurationType::Instant;
+}
+
+bool URadialDamageSubsystem::IsTickable() const
+{
+	return ResolvedTargets.Num() > 0 || AccumulatedDamage.Num() > 0;
+}
+
+TStatId URadialDamageSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URadialDamageSubsystem, STATGROUP_Tickables);
+}
+
+void URadialDamageSubsystem::QueueRadialDamage(UObject* WorldContextObject, AActor* DamageCauser, const FVector& Location, float Radius, float DamageAmount, const TArray<TSubclassOf<UGameplayEffect>>& DamageEffects, const TArray<TEnumAsByte<EObjectTypeQuery>>& ObjectTypes, ETraceTypeQuery TraceType)
+{
+	UWorld* World = GetWorld();
+
+	if (!World) return;
+
+	const uint32 ExplosionId = NextExplosionId++;
+
+	FQueuedRadialDamage& Explosion = Explosions.Add(ExplosionId);
+	Explosion.WorldContextObject = WorldContextObject;
+	Explosion.DamageCauser = DamageCauser;
+	Explosion.Location = Location;
+	Explosion.DamageAmount = DamageAmount;
+	Explosion.DamageEffects = DamageEffects;
+	Explosion.TraceChannel = UEngineTypes::ConvertToCollisionChannel(TraceType);
+
+	World->AsyncOverlapByObjectType(Location, FQuat::Identity, FCollisionObjectQueryParams(ObjectTypes), FCollisionShape::MakeSphere(Radius), MakeQueryParams(Explosion), &OverlapDelegate, ExplosionId);
+
+	INC_DWORD_STAT(STAT_RadialDamageQueued);
+}
+
+FCollisionQueryParams URadialDamageSubsystem::MakeQueryParams(const FQueuedRadialDamage& Explosion) const
+{
+	static const FName RadialDamageQueryName = TEXT("RadialDamage");
+
+	// Match the sync path: complex traces that ignore the causer and the calling actor
+	FCollisionQueryParams QueryParams(RadialDamageQueryName, true);
+	QueryParams.AddIgnoredActor(Explosion.DamageCauser.Get());
+	QueryParams.AddIgnoredActor(Cast<AActor>(Explosion.WorldContextObject.Get()));
+
+	return QueryParams;
+}
+
+void URadialDamageSubsystem::OnOverlapCompleted(const FTraceHandle& Handle, FOverlapDatum& Datum)
+{
+	const uint32 ExplosionId = Datum.UserData;
+
+	FQueuedRadialDamage* Explosion = Explosions.Find(ExplosionId);
+	UWorld* World = GetWorld();
+
+	if (!Explosion || !World) return;
+
+	TArray<AActor*, TInlineAllocator<16>> OverlappedActors;
+
+	for (const FOverlapResult& Overlap : Datum.OutOverlaps)
+	{
+		if (AActor* Actor = Overlap.GetActor())
+		{
+			OverlappedActors.AddUnique(Actor);
+		}
+	}
+
+	const FCollisionQueryParams QueryParams = MakeQueryParams(*Explosion);
+
+	for (AActor* Actor : OverlappedActors)
+	{
+		const uint32 TraceId = NextTraceId++;
+
+		FRadialDamageTarget& Target = PendingTargets.Add(TraceId);
+		Target.ExplosionId = ExplosionId;
+		Target.Actor = Actor;
+
+		World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Explosion->Location, Actor->GetActorLocation(), Explosion->TraceChannel, QueryParams, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, TraceId);
+
+		++Explosion->PendingTraces;
+	}
+
+	if (Explosion->PendingTraces == 0)
+	{
+		Explosions.Remove(ExplosionId);
+	}
+}
+
+void URadialDamageSubsystem::OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	FRadialDamageTarget Target;
+
+	if (!PendingTargets.RemoveAndCopyValue(Datum.UserData, Target)) return;
+
+	if (const FHitResult* BlockingHit = FHitResult::GetFirstBlockingHit(Datum.OutHits))
+	{
+		Target.HitResult = *BlockingHit;
+		Target.bHit = true;
+	}
+
+	ResolvedTargets.Add(MoveTemp(Target));
+
+	INC_DWORD_STAT(STAT_RadialDamageResolved);
+}
+
+void URadialDamageSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	for (const FRadialDamageTarget& Target : ResolvedTargets)
+	{
+		FQueuedRadialDamage* Explosion = Explosions.Find(Target.ExplosionId);
+
+		if (!Explosion) continue;
+
+		AActor* Actor = Target.Actor.Get();
+		UObject* WorldContextObject = Explosion->WorldContextObject.IsValid() ? Explosion->WorldContextObject.Get() : this;
+
+		if (Actor)
+		{
+			UActionGameStatics::ApplyRadialDamageToActor(WorldContextObject, Explosion->DamageCauser.Get(), Explosion->Location, Actor, Target.HitResult, Target.bHit, Explosion->DamageAmount, Explosion->DamageEffects);
+
+			INC_DWORD_STAT(STAT_RadialDamageApplied);
+		}
+
+		if (--Explosion->PendingTraces <= 0)
+		{
+			Explosions.Remove(Target.ExplosionId);
+		}
+	}
+
+	ResolvedTargets.Reset();
+
+	FlushAccumulatedDamage();
+}
+
+void URadialDamageSubsystem::AccumulateDamage(UAbilitySystemComponent* TargetComponent, TSubclassOf<UGameplayEffect> DamageEffect, AActor* DamageCauser, float DamageAmount)
+{
+	FRadialDamageAccumulatorKey Key;
+	Key.TargetComponent = TargetComponent;
+	Key.DamageEffect = DamageEffect;
+	Key.DamageCauser = DamageCauser;
+
+	AccumulatedDamage.FindOrAdd(Key) += DamageAmount;
+
+	INC_DWORD_STAT(STAT_RadialDamageCoalesced);
+}
+
+void URadialDamageSubsystem::FlushAccumulatedDamage()
+{
+	// Applying can trigger more radial damage, so work on a local copy
+	TMap<FRadialDamageAccumulatorKey, float> DamageToApply = MoveTemp(AccumulatedDamage);
+	AccumulatedDamage.Reset();
+
+	for (const auto& DamagePair : DamageToApply)
+	{
+		if (UAbilitySystemComponent* TargetComponent = DamagePair.Key.TargetComponent.Get())
+		{
+			UActionGameStatics::ApplyDamageEffect(TargetComponent, DamagePair.Key.DamageEffect, DamagePair.Key.DamageCauser.Get(), DamagePair.Value);
+
+			INC_DWORD_STAT(STAT_RadialDamageSpecsApplied);
+		}
+	}
+}
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "RadialDamageSubsystem.generated.h"
+
+class UGameplayEffect;
+class UAbilitySystemComponent;
+
+struct FQueuedRadialDamage
+{
+	TWeakObjectPtr<UObject> WorldContextObject;
+
+	TWeakObjectPtr<AActor> DamageCauser;
+
+	FVector Location = FVector::ZeroVector;
+
+	float DamageAmount = 0.f;
+
+	TArray<TSubclassOf<UGameplayEffect>> DamageEffects;
+
+	ECollisionChannel TraceChannel = ECC_Visibility;
+
+	int32 PendingTraces = 0;
+};
+
+struct FRadialDamageTarget
+{
+	uint32 ExplosionId = 0;
+
+	TWeakObjectPtr<AActor> Actor;
+
+	FHitResult HitResult;
+
+	bool bHit = false;
+};
+
+struct FRadialDamageAccumulatorKey
+{
+	TWeakObjectPtr<UAbilitySystemComponent> TargetComponent;
+
+	TSubclassOf<UGameplayEffect> DamageEffect;
+
+	TWeakObjectPtr<AActor> DamageCauser;
+
+	bool operator==(const FRadialDamageAccumulatorKey& Other) const
+	{
+		return TargetComponent == Other.TargetComponent && DamageEffect == Other.DamageEffect && DamageCauser == Other.DamageCauser;
+	}
+
+	friend uint32 GetTypeHash(const FRadialDamageAccumulatorKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.TargetComponent), GetTypeHash(Key.DamageEffect)), GetTypeHash(Key.DamageCauser));
+	}
+};
+
+/**
+ * Resolves radial damage with async scene queries instead of blocking the game thread.
+ * The overlap and the per target line of sight traces run on the physics worker and all targets
+ * resolved during a frame have their damage applied in one pass at the start of the next.
+ * Instant damage from every explosion in a frame is summed per target, effect and causer and applied as one spec.
+ */
+UCLASS()
+class ACTIONGAME_API URadialDamageSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void QueueRadialDamage(UObject* WorldContextObject, AActor* DamageCauser, const FVector& Location, float Radius, float DamageAmount, const TArray<TSubclassOf<UGameplayEffect>>& DamageEffects, const TArray<TEnumAsByte<EObjectTypeQuery>>& ObjectTypes, ETraceTypeQuery TraceType);
+
+	void AccumulateDamage(UAbilitySystemComponent* TargetComponent, TSubclassOf<UGameplayEffect> DamageEffect, AActor* DamageCauser, float DamageAmount);
+
+	static bool IsAsyncEnabled();
+
+	static bool IsCoalescingEnabled();
+
+	/** Only instant effects are summed, duration and periodic effects each keep their own spec */
+	static bool CanCoalesce(TSubclassOf<UGameplayEffect> DamageEffect);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	FCollisionQueryParams MakeQueryParams(const FQueuedRadialDamage& Explosion) const;
+
+	void OnOverlapCompleted(const FTraceHandle& Handle, FOverlapDatum& Datum);
+
+	void OnTraceCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	void FlushAccumulatedDamage();
+
+	FOverlapDelegate OverlapDelegate;
+
+	FTraceDelegate TraceDelegate;
+
+	TMap<uint32, FQueuedRadialDamage> Explosions;
+
+	TMap<uint32, FRadialDamageTarget> PendingTargets;
+
+	TArray<FRadialDamageTarget> ResolvedTargets;
+
+	TMap<FRadialDamageAccumulatorKey, float> AccumulatedDamage;
+
+	uint32 NextExplosionId = 1;
+
+	uint32 NextTraceId = 1;
+};
@@ -0,0 +1,419 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WorldItemSubsystem.h"
+#include "ActionGame.h"
+#include "ActionGameStatics.h"
+#include "Actors/ItemActor.h"
+#include "Actors/WorldItemManager.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("World Items Update"), STAT_WorldItemsUpdate, STATGROUP_ActionGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Item Records"), STAT_WorldItemRecords, STATGROUP_ActionGame);
+DECLARE_DWORD_COUNTER_STAT(TEXT("World Item Actors"), STAT_WorldItemActors, STATGROUP_ActionGame);
+
+static TAutoConsoleVariable<int32> CVarWorldItemsEnabled(
+	TEXT("WorldItems.Enabled"),
+	1,
+	TEXT("Store unclaimed items that have a world mesh as records instead of item actors, read when a level begins play")
+	TEXT(" 0: Off\n")
+	TEXT(" 1: On\n"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarWorldItemsPromoteDistance(
+	TEXT("WorldItems.PromoteDistance"),
+	1000.f,
+	TEXT("Distance from a player at which a world item becomes an item actor, at most the cell size"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarWorldItemsDemoteDistance(
+	TEXT("WorldItems.DemoteDistance"),
+	1500.f,
+	TEXT("Distance from every player beyond which an unclaimed item actor goes back to being a record, kept above the promote distance"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarItemsPrefetchDistance(
+	TEXT("Items.PrefetchDistance"),
+	2000.f,
+	TEXT("Distance from a local player at which a host starts streaming an unclaimed pickup's content"),
+	ECVF_Default
+);
+
+static TAutoConsoleVariable<float> CVarWorldItemsUpdateInterval(
+	TEXT("WorldItems.UpdateInterval"),
+	0.25f,
+	TEXT("Seconds between promotion and demotion passes"),
+	ECVF_Default
+);
+
+// Cells span the largest promote distance, so a player only ever looks at the cells around its own
+static const float WorldItemCellSize = 1000.f;
+
+void UWorldItemSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Without a manager every item stays an actor, as if world items did not exist
+	if (InWorld.GetNetMode() == NM_Client || CVarWorldItemsEnabled.GetValueOnGameThread() == 0) return;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	Manager = InWorld.SpawnActor<AWorldItemManager>(SpawnParams);
+
+	if (!Manager) return;
+
+	// Pickups in the levels loaded with the map become records before they ever begin play
+	for (ULevel* Level : InWorld.GetLevels())
+	{
+		ConvertPlacedItems(Level);
+	}
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UWorldItemSubsystem::OnLevelAdded);
+	LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UWorldItemSubsystem::OnLevelRemoved);
+}
+
+void UWorldItemSubsystem::ConvertPlacedItems(ULevel* InLevel)
+{
+	if (!InLevel) return;
+
+	// Walked by index, destroying an actor clears its slot in the level
+	for (int32 Index = 0; Index < InLevel->Actors.Num(); ++Index)
+	{
+		AItemActor* ItemActor = Cast<AItemActor>(InLevel->Actors[Index]);
+
+		if (!IsValid(ItemActor) || ItemActor->GetOwner() || !CanStoreAsRecord(ItemActor->GetItemStaticDataClass())) continue;
+
+		AddWorldItem(ItemActor->GetItemStaticDataClass(), ItemActor->GetActorTransform(), InLevel);
+
+		ItemActor->Destroy();
+	}
+}
+
+void UWorldItemSubsystem::OnLevelAdded(ULevel* InLevel, UWorld* InWorld)
+{
+	// Streamed pickups have already begun play by now, they are converted on the same frame
+	if (InWorld == GetWorld() && Manager)
+	{
+		ConvertPlacedItems(InLevel);
+	}
+}
+
+void UWorldItemSubsystem::OnLevelRemoved(ULevel* InLevel, UWorld* InWorld)
+{
+	if (InWorld != GetWorld() || !Manager || !InLevel) return;
+
+	// A level streamed back in brings its placed pickups again, like any streamed actor
+	TArray<int32> LevelRecords;
+
+	for (const TPair<int32, FWorldItemRecord>& Record : Records)
+	{
+		if (Record.Value.Level == InLevel)
+		{
+			LevelRecords.Add(Record.Key);
+		}
+	}
+
+	FWorldItemRecord Record;
+
+	for (const int32 RecordId : LevelRecords)
+	{
+		TakeRecord(RecordId, Record);
+	}
+}
+
+void UWorldItemSubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+	Records.Reset();
+	Cells.Reset();
+	PromotedActors.Reset();
+	PrefetchCells.Reset();
+	Manager = nullptr;
+
+	Super::Deinitialize();
+}
+
+bool UWorldItemSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UWorldItemSubsystem::IsTickable() const
+{
+	return (Manager && (Records.Num() > 0 || PromotedActors.Num() > 0)) || PrefetchCells.Num() > 0;
+}
+
+TStatId UWorldItemSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWorldItemSubsystem, STATGROUP_Tickables);
+}
+
+bool UWorldItemSubsystem::CanStoreAsRecord(TSubclassOf<UItemStaticData> InItemStaticDataClass)
+{
+	const UItemStaticData* ItemStaticData = UActionGameStatics::GetItemStaticData(InItemStaticDataClass);
+
+	return ItemStaticData && ItemStaticData->ItemActorClass && !ItemStaticData->WorldStaticMesh.IsNull();
+}
+
+FIntVector UWorldItemSubsystem::GetCell(const FVector& Location)
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / WorldItemCellSize),
+		FMath::FloorToInt(Location.Y / WorldItemCellSize),
+		FMath::FloorToInt(Location.Z / WorldItemCellSize));
+}
+
+int32 UWorldItemSubsystem::AddWorldItem(TSubclassOf<UItemStaticData> InItemStaticDataClass, const FTransform& Transform, ULevel* InLevel, UInventoryItemInstance* InItemInstance)
+{
+	if (!Manager || !CanStoreAsRecord(InItemStaticDataClass)) return 0;
+
+	const int32 RecordId = NextRecordId++;
+
+	FWorldItemRecord& Record = Records.Add(RecordId);
+	Record.ItemStaticDataClass = InItemStaticDataClass;
+	Record.Transform = Transform;
+	Record.ItemInstance = InItemInstance;
+	Record.Level = InLevel;
+	Record.Cell = GetCell(Transform.GetLocation());
+
+	Cells.FindOrAdd(Record.Cell).Add(RecordId);
+
+	Manager->AddRecord(RecordId, InItemStaticDataClass, Transform);
+
+	return RecordId;
+}
+
+void UWorldItemSubsystem::TrackItemActor(AItemActor* ItemActor)
+{
+	if (Manager && ItemActor && CanStoreAsRecord(ItemActor->GetItemStaticDataClass()))
+	{
+		PromotedActors.AddUnique(ItemActor);
+	}
+}
+
+bool UWorldItemSubsystem::TakeRecord(int32 RecordId, FWorldItemRecord& OutRecord)
+{
+	if (!Records.RemoveAndCopyValue(RecordId, OutRecord)) return false;
+
+	if (TArray<int32, TInlineAllocator<4>>* CellRecords = Cells.Find(OutRecord.Cell))
+	{
+		CellRecords->RemoveSingleSwap(RecordId);
+
+		if (CellRecords->Num() == 0)
+		{
+			Cells.Remove(OutRecord.Cell);
+		}
+	}
+
+	Manager->RemoveRecord(RecordId);
+
+	return true;
+}
+
+void UWorldItemSubsystem::TrackPrefetch(AItemActor* ItemActor)
+{
+	if (ItemActor)
+	{
+		PrefetchCells.FindOrAdd(GetCell(ItemActor->GetActorLocation())).Add(ItemActor);
+	}
+}
+
+void UWorldItemSubsystem::UpdatePrefetch(const TArray<FVector, TInlineAllocator<16>>& LocalPlayerLocations)
+{
+	if (PrefetchCells.Num() == 0) return;
+
+	const float PrefetchDistance = CVarItemsPrefetchDistance.GetValueOnGameThread();
+	const int32 CellRange = FMath::CeilToInt(PrefetchDistance / WorldItemCellSize);
+
+	for (const FVector& PlayerLocation : LocalPlayerLocations)
+	{
+		const FIntVector PlayerCell = GetCell(PlayerLocation);
+
+		for (int32 X = -CellRange; X <= CellRange; ++X)
+		{
+			for (int32 Y = -CellRange; Y <= CellRange; ++Y)
+			{
+				for (int32 Z = -CellRange; Z <= CellRange; ++Z)
+				{
+					const FIntVector Cell = PlayerCell + FIntVector(X, Y, Z);
+
+					TArray<TWeakObjectPtr<AItemActor>, TInlineAllocator<4>>* CellActors = PrefetchCells.Find(Cell);
+
+					if (!CellActors) continue;
+
+					for (int32 Index = CellActors->Num() - 1; Index >= 0; --Index)
+					{
+						AItemActor* ItemActor = (*CellActors)[Index].Get();
+
+						// Claimed items are kept loaded by their inventory
+						if (!ItemActor || !ItemActor->IsUnclaimed())
+						{
+							CellActors->RemoveAtSwap(Index, 1, false);
+							continue;
+						}
+
+						if (FVector::DistSquared(PlayerLocation, ItemActor->GetActorLocation()) <= FMath::Square(PrefetchDistance))
+						{
+							ItemActor->RequestItemAssets();
+
+							CellActors->RemoveAtSwap(Index, 1, false);
+						}
+					}
+
+					if (CellActors->Num() == 0)
+					{
+						PrefetchCells.Remove(Cell);
+					}
+				}
+			}
+		}
+	}
+}
+
+void UWorldItemSubsystem::PromoteRecord(int32 RecordId)
+{
+	FWorldItemRecord Record;
+
+	if (!TakeRecord(RecordId, Record)) return;
+
+	const UItemStaticData* ItemStaticData = UActionGameStatics::GetItemStaticData(Record.ItemStaticDataClass);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.OverrideLevel = Record.Level.Get();
+	SpawnParams.bDeferConstruction = true;
+
+	if (AItemActor* ItemActor = GetWorld()->SpawnActor<AItemActor>(ItemStaticData->ItemActorClass, Record.Transform, SpawnParams))
+	{
+		// A demoted item gets its own instance back, a placed one creates a new instance as it begins play
+		if (IsValid(Record.ItemInstance))
+		{
+			ItemActor->Init(Record.ItemInstance);
+		}
+		else
+		{
+			ItemActor->SetItemStaticDataClass(Record.ItemStaticDataClass);
+		}
+		ItemActor->FinishSpawning(Record.Transform);
+
+		PromotedActors.Add(ItemActor);
+	}
+}
+
+void UWorldItemSubsystem::DemoteItemActor(AItemActor* ItemActor)
+{
+	AddWorldItem(ItemActor->GetItemStaticDataClass(), ItemActor->GetActorTransform(), ItemActor->GetLevel(), ItemActor->GetItemInstance());
+
+	ItemActor->Destroy();
+}
+
+void UWorldItemSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_WorldItemsUpdate);
+
+	Super::Tick(DeltaTime);
+
+	UWorld* World = GetWorld();
+
+	const double Now = World->GetTimeSeconds();
+
+	if (Now < NextUpdateTime) return;
+
+	NextUpdateTime = Now + CVarWorldItemsUpdateInterval.GetValueOnGameThread();
+
+	TArray<FVector, TInlineAllocator<16>> PlayerLocations;
+	TArray<FVector, TInlineAllocator<16>> LocalPlayerLocations;
+
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+
+		if (const APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr)
+		{
+			PlayerLocations.Add(Pawn->GetActorLocation());
+
+			if (PlayerController->IsLocalController())
+			{
+				LocalPlayerLocations.Add(Pawn->GetActorLocation());
+			}
+		}
+	}
+
+	UpdatePrefetch(LocalPlayerLocations);
+
+	const float PromoteDistance = FMath::Min(CVarWorldItemsPromoteDistance.GetValueOnGameThread(), WorldItemCellSize);
+	const float DemoteDistance = FMath::Max(CVarWorldItemsDemoteDistance.GetValueOnGameThread(), PromoteDistance);
+
+	for (int32 Index = PromotedActors.Num() - 1; Index >= 0; --Index)
+	{
+		AItemActor* ItemActor = PromotedActors[Index].Get();
+
+		// Claimed items belong to an inventory now and are no longer the world's business
+		if (!ItemActor || !ItemActor->IsUnclaimed())
+		{
+			PromotedActors.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		const FVector Location = ItemActor->GetActorLocation();
+
+		const bool bPlayerNear = PlayerLocations.ContainsByPredicate([&Location, DemoteDistance](const FVector& PlayerLocation)
+		{
+			return FVector::DistSquared(PlayerLocation, Location) <= FMath::Square(DemoteDistance);
+		});
+
+		if (!bPlayerNear)
+		{
+			PromotedActors.RemoveAtSwap(Index, 1, false);
+
+			DemoteItemActor(ItemActor);
+		}
+	}
+
+	TArray<int32, TInlineAllocator<16>> RecordsToPromote;
+
+	for (const FVector& PlayerLocation : PlayerLocations)
+	{
+		const FIntVector PlayerCell = GetCell(PlayerLocation);
+
+		for (int32 X = -1; X <= 1; ++X)
+		{
+			for (int32 Y = -1; Y <= 1; ++Y)
+			{
+				for (int32 Z = -1; Z <= 1; ++Z)
+				{
+					const TArray<int32, TInlineAllocator<4>>* CellRecords = Cells.Find(PlayerCell + FIntVector(X, Y, Z));
+
+					if (!CellRecords) continue;
+
+					for (const int32 RecordId : *CellRecords)
+					{
+						const FWorldItemRecord& Record = Records[RecordId];
+
+						if (FVector::DistSquared(PlayerLocation, Record.Transform.GetLocation()) <= FMath::Square(PromoteDistance))
+						{
+							RecordsToPromote.AddUnique(RecordId);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	for (const int32 RecordId : RecordsToPromote)
+	{
+		PromoteRecord(RecordId);
+	}
+
+	SET_DWORD_STAT(STAT_WorldItemRecords, Records.Num());
+	SET_DWORD_STAT(STAT_WorldItemActors, PromotedActors.Num());
+}
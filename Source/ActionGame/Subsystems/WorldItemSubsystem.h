@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ActionGameTypes.h"
+#include "WorldItemSubsystem.generated.h"
+
+class AItemActor;
+class AWorldItemManager;
+class UInventoryItemInstance;
+class ULevel;
+
+/** An unclaimed item waiting in the world without an actor */
+USTRUCT()
+struct FWorldItemRecord
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TSubclassOf<UItemStaticData> ItemStaticDataClass;
+
+	UPROPERTY()
+	FTransform Transform;
+
+	/** Set for demoted items, so everything about the instance survives until it is promoted again */
+	UPROPERTY()
+	TObjectPtr<UInventoryItemInstance> ItemInstance = nullptr;
+
+	/** Level the item was placed or dropped in, its records and actors go away with it */
+	UPROPERTY()
+	TWeakObjectPtr<ULevel> Level;
+
+	FIntVector Cell = FIntVector::ZeroValue;
+};
+
+/**
+ * Keeps unclaimed items as records in a spatial hash on the server, so actor count and overlap cost scale with players instead of loot.
+ * A record is promoted to an item actor once a player is within WorldItems.PromoteDistance, and demoted back once no player is within WorldItems.DemoteDistance.
+ */
+UCLASS()
+class ACTIONGAME_API UWorldItemSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	/** Only items with a world mesh can wait without an actor */
+	static bool CanStoreAsRecord(TSubclassOf<UItemStaticData> InItemStaticDataClass);
+
+	int32 AddWorldItem(TSubclassOf<UItemStaticData> InItemStaticDataClass, const FTransform& Transform, ULevel* InLevel = nullptr, UInventoryItemInstance* InItemInstance = nullptr);
+
+	/** Lets an unclaimed item actor, like a dropped item, be demoted once nobody is near */
+	void TrackItemActor(AItemActor* ItemActor);
+
+	/** Requests a host's pickup content once a local player is within Items.PrefetchDistance */
+	void TrackPrefetch(AItemActor* ItemActor);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Pickups placed in the level become records, for the persistent level at begin play and for levels streamed in later */
+	void ConvertPlacedItems(ULevel* InLevel);
+
+	void OnLevelAdded(ULevel* InLevel, UWorld* InWorld);
+
+	void OnLevelRemoved(ULevel* InLevel, UWorld* InWorld);
+
+	bool TakeRecord(int32 RecordId, FWorldItemRecord& OutRecord);
+
+	void PromoteRecord(int32 RecordId);
+
+	void DemoteItemActor(AItemActor* ItemActor);
+
+	void UpdatePrefetch(const TArray<FVector, TInlineAllocator<16>>& LocalPlayerLocations);
+
+	static FIntVector GetCell(const FVector& Location);
+
+	UPROPERTY()
+	TMap<int32, FWorldItemRecord> Records;
+
+	TMap<FIntVector, TArray<int32, TInlineAllocator<4>>> Cells;
+
+	TArray<TWeakObjectPtr<AItemActor>> PromotedActors;
+
+	/** Pickups whose content a host has not requested yet, hashed into the same cells as the records */
+	TMap<FIntVector, TArray<TWeakObjectPtr<AItemActor>, TInlineAllocator<4>>> PrefetchCells;
+
+	UPROPERTY()
+	TObjectPtr<AWorldItemManager> Manager = nullptr;
+
+	int32 NextRecordId = 1;
+
+	double NextUpdateTime = 0.;
+
+	FDelegateHandle LevelAddedHandle;
+
+	FDelegateHandle LevelRemovedHandle;
+};
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActionGameGameplayTags.h"
+#include "GameplayTagsSettings.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNativeGameplayTagsInConfigTest, "ActionGame.GameplayTags.NativeTagsInConfig", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNativeGameplayTagsInConfigTest::RunTest(const FString& Parameters)
+{
+	// Native tags still work without an ini entry, but assets and designers only see tags listed in DefaultGameplayTags.ini
+	const UGameplayTagsSettings* Settings = GetDefault<UGameplayTagsSettings>();
+
+	const TArray<FName>& TagNames = FActionGameGameplayTags::Get().GetTagNames();
+
+	TestTrue(TEXT("Native tags are initialized"), TagNames.Num() > 0);
+
+	for (const FName& TagName : TagNames)
+	{
+		const bool bInConfig = Settings->GameplayTagList.ContainsByPredicate([&TagName](const FGameplayTagTableRow& Row) { return Row.Tag == TagName; });
+
+		TestTrue(FString::Printf(TEXT("Native gameplay tag %s is listed in DefaultGameplayTags.ini"), *TagName.ToString()), bInConfig);
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActionGameTypes.h"
+#include "Inventory/InventoryItemInstance.h"
+#include "Inventory/InventoryList.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeExit.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventoryRemovalOrderTest, "ActionGame.Inventory.RemovalKeepsOrder", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInventoryRemovalOrderTest::RunTest(const FString& Parameters)
+{
+	// Weapons are only equippable once their Blueprint says so, the test sets it on the native defaults instead
+	UWeaponStaticData* WeaponDefaults = GetMutableDefault<UWeaponStaticData>();
+	const bool bPreviousCanBeEquipped = WeaponDefaults->bCanBeEquipped;
+	WeaponDefaults->bCanBeEquipped = true;
+
+	ON_SCOPE_EXIT
+	{
+		WeaponDefaults->bCanBeEquipped = bPreviousCanBeEquipped;
+	};
+
+	FInventoryList InventoryList;
+
+	UInventoryItemInstance* FirstWeapon = InventoryList.AddItem(UWeaponStaticData::StaticClass());
+	UInventoryItemInstance* Item = InventoryList.AddItem(UItemStaticData::StaticClass());
+	UInventoryItemInstance* SecondWeapon = InventoryList.AddItem(UWeaponStaticData::StaticClass());
+	UInventoryItemInstance* ThirdWeapon = InventoryList.AddItem(UWeaponStaticData::StaticClass());
+
+	if (!FirstWeapon || !Item || !SecondWeapon || !ThirdWeapon)
+	{
+		AddError(TEXT("Could not add the items"));
+		return false;
+	}
+
+	TestTrue(TEXT("FindItem matches the exact class"), InventoryList.FindItem(UItemStaticData::StaticClass()) == Item);
+	TestTrue(TEXT("FindItem returns the oldest item of the class"), InventoryList.FindItem(UWeaponStaticData::StaticClass()) == FirstWeapon);
+
+	const FInventorySlotHandle FirstWeaponHandle = InventoryList.GetSlotHandle(FirstWeapon);
+	const FInventorySlotHandle ThirdWeaponHandle = InventoryList.GetSlotHandle(ThirdWeapon);
+
+	TestTrue(TEXT("Items in the list have a handle"), FirstWeaponHandle.IsValid() && ThirdWeaponHandle.IsValid());
+
+	InventoryList.RemoveItem(FirstWeapon);
+
+	const TArray<FInventoryListItem>& Items = InventoryList.GetItems();
+
+	if (!TestEqual(TEXT("One entry was removed"), Items.Num(), 3)) return false;
+
+	TestTrue(TEXT("The remaining entries keep their order"), Items[0].ItemInstance == Item && Items[1].ItemInstance == SecondWeapon && Items[2].ItemInstance == ThirdWeapon);
+
+	TestNull(TEXT("The removed item's handle no longer resolves"), InventoryList.ResolveSlotHandle(FirstWeaponHandle));
+
+	const FInventoryListItem* ThirdWeaponEntry = InventoryList.ResolveSlotHandle(ThirdWeaponHandle);
+	TestTrue(TEXT("A moved item's handle still resolves to it"), ThirdWeaponEntry && ThirdWeaponEntry->ItemInstance == ThirdWeapon);
+
+	TestTrue(TEXT("EquipNext starts with the oldest weapon"), InventoryList.FindNextEquippable(nullptr) == SecondWeapon);
+	TestTrue(TEXT("EquipNext follows pickup order"), InventoryList.FindNextEquippable(SecondWeapon) == ThirdWeapon);
+	TestTrue(TEXT("EquipNext wraps around"), InventoryList.FindNextEquippable(ThirdWeapon) == SecondWeapon);
+
+	TestTrue(TEXT("Removal by class takes an item of that class first"), InventoryList.RemoveItem(UItemStaticData::StaticClass()) == Item);
+	TestTrue(TEXT("Removal by class then takes the first derived item"), InventoryList.RemoveItem(UItemStaticData::StaticClass()) == SecondWeapon);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,258 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Subsystems/PlayerSnapshotSubsystem.h"
+#include "ActionGameCharacter.h"
+#include "ActionGameTypes.h"
+#include "ActorComponents/InventoryComponent.h"
+#include "Engine/GameInstance.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/ScopeExit.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Tests/ActionGameTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayerSnapshotBenchmarkTest, "ActionGame.PlayerSnapshot.SaveLoad100Players", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlayerSnapshotBenchmarkTest::RunTest(const FString& Parameters)
+{
+	static const int32 NumPlayers = 100;
+	static const int32 NumItemsPerPlayer = 16;
+
+	TArray<FPlayerSnapshot> Snapshots;
+	Snapshots.SetNum(NumPlayers);
+
+	// A loadout of a few weapons and many stacks, the shape a full server saves on map change
+	for (int32 PlayerIndex = 0; PlayerIndex < NumPlayers; ++PlayerIndex)
+	{
+		FPlayerSnapshot& Snapshot = Snapshots[PlayerIndex];
+
+		for (int32 ItemIndex = 0; ItemIndex < NumItemsPerPlayer; ++ItemIndex)
+		{
+			FInventoryItemSnapshot& Item = Snapshot.Inventory.Items.AddDefaulted_GetRef();
+			Item.ItemStaticDataClass = ItemIndex < 3 ? UWeaponStaticData::StaticClass() : UItemStaticData::StaticClass();
+			Item.StackCount = (uint16)(ItemIndex < 3 ? 1 : 1 + (PlayerIndex + ItemIndex) % 99);
+			Item.StateFlags = (uint8)(ItemIndex % 4);
+		}
+
+		Snapshot.Inventory.EquippedIndex = PlayerIndex % 3;
+		Snapshot.Health = 100.f - PlayerIndex % 50;
+		Snapshot.Stamina = 50.f + PlayerIndex % 25;
+		Snapshot.MaxMovementSpeed = 600.f;
+	}
+
+	TArray<TArray<uint8>> SnapshotData;
+	SnapshotData.SetNum(NumPlayers);
+
+	const double SaveStartTime = FPlatformTime::Seconds();
+
+	for (int32 PlayerIndex = 0; PlayerIndex < NumPlayers; ++PlayerIndex)
+	{
+		FMemoryWriter Writer(SnapshotData[PlayerIndex]);
+		UPlayerSnapshotSubsystem::SerializeSnapshot(Writer, Snapshots[PlayerIndex]);
+	}
+
+	const double SaveSeconds = FPlatformTime::Seconds() - SaveStartTime;
+
+	TArray<FPlayerSnapshot> LoadedSnapshots;
+	LoadedSnapshots.SetNum(NumPlayers);
+
+	const double LoadStartTime = FPlatformTime::Seconds();
+
+	for (int32 PlayerIndex = 0; PlayerIndex < NumPlayers; ++PlayerIndex)
+	{
+		FMemoryReader Reader(SnapshotData[PlayerIndex]);
+
+		if (!UPlayerSnapshotSubsystem::SerializeSnapshot(Reader, LoadedSnapshots[PlayerIndex]))
+		{
+			AddError(FString::Printf(TEXT("Snapshot of player %d could not be read back"), PlayerIndex));
+			return false;
+		}
+	}
+
+	const double LoadSeconds = FPlatformTime::Seconds() - LoadStartTime;
+
+	int64 TotalBytes = 0;
+
+	for (int32 PlayerIndex = 0; PlayerIndex < NumPlayers; ++PlayerIndex)
+	{
+		const FPlayerSnapshot& Saved = Snapshots[PlayerIndex];
+		const FPlayerSnapshot& Loaded = LoadedSnapshots[PlayerIndex];
+
+		TotalBytes += SnapshotData[PlayerIndex].Num();
+
+		TestEqual(TEXT("Item count survives the round trip"), Loaded.Inventory.Items.Num(), Saved.Inventory.Items.Num());
+		TestEqual(TEXT("Equipped index survives the round trip"), Loaded.Inventory.EquippedIndex, Saved.Inventory.EquippedIndex);
+		TestEqual(TEXT("Health survives the round trip"), Loaded.Health, Saved.Health);
+
+		for (int32 ItemIndex = 0; ItemIndex < FMath::Min(Saved.Inventory.Items.Num(), Loaded.Inventory.Items.Num()); ++ItemIndex)
+		{
+			const FInventoryItemSnapshot& SavedItem = Saved.Inventory.Items[ItemIndex];
+			const FInventoryItemSnapshot& LoadedItem = Loaded.Inventory.Items[ItemIndex];
+
+			if (LoadedItem.ItemStaticDataClass != SavedItem.ItemStaticDataClass || LoadedItem.StackCount != SavedItem.StackCount || LoadedItem.StateFlags != SavedItem.StateFlags)
+			{
+				AddError(FString::Printf(TEXT("Item %d of player %d changed in the round trip"), ItemIndex, PlayerIndex));
+				return false;
+			}
+		}
+	}
+
+	AddInfo(FString::Printf(TEXT("Saved %d players in %.3f ms and loaded them in %.3f ms, %lld bytes in total"), NumPlayers, SaveSeconds * 1000., LoadSeconds * 1000., TotalBytes));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayerSnapshotCorruptClassCountTest, "ActionGame.PlayerSnapshot.RejectsCorruptClassCount", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlayerSnapshotCorruptClassCountTest::RunTest(const FString& Parameters)
+{
+	FPlayerSnapshot Snapshot;
+
+	TArray<uint8> Data;
+
+	FMemoryWriter Writer(Data);
+	UPlayerSnapshotSubsystem::SerializeSnapshot(Writer, Snapshot);
+
+	// The class count follows the magic and the version
+	int32 CorruptClassCount = MAX_int32;
+	FMemory::Memcpy(Data.GetData() + 2 * sizeof(uint32), &CorruptClassCount, sizeof(CorruptClassCount));
+
+	FMemoryReader Reader(Data);
+
+	TestFalse(TEXT("A class count the data cannot hold is rejected before allocating"), UPlayerSnapshotSubsystem::SerializeSnapshot(Reader, Snapshot));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayerSnapshotRestoreBenchmarkTest, "ActionGame.PlayerSnapshot.Restore100Players", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlayerSnapshotRestoreBenchmarkTest::RunTest(const FString& Parameters)
+{
+	static const int32 NumPlayers = 100;
+	static const int32 NumTestItemsPerPlayer = 13;
+
+	// A quarter of a 60 Hz frame, reported next to the timings rather than asserted since they depend on the machine
+	static const double RestoreBudgetSeconds = 0.25 / 60.;
+
+	static const TCHAR* WeaponClassPaths[] =
+	{
+		TEXT("/Game/Blueprints/Inventory/Items/Pistol.Pistol_C"),
+		TEXT("/Game/Blueprints/Inventory/Items/Rifle.Rifle_C"),
+		TEXT("/Game/Blueprints/Inventory/Items/RocketLauncher.RocketLauncher_C"),
+	};
+
+	TArray<TSubclassOf<UItemStaticData>> WeaponClasses;
+
+	for (const TCHAR* WeaponClassPath : WeaponClassPaths)
+	{
+		WeaponClasses.Add(LoadClass<UItemStaticData>(nullptr, WeaponClassPath));
+
+		if (!WeaponClasses.Last())
+		{
+			AddError(FString::Printf(TEXT("Could not load %s"), WeaponClassPath));
+			return false;
+		}
+	}
+
+	TSubclassOf<UItemStaticData> TestItemClass = LoadClass<UItemStaticData>(nullptr, TEXT("/Game/Blueprints/Inventory/Items/TestItem.TestItem_C"));
+
+	if (!TestItemClass)
+	{
+		TestItemClass = UItemStaticData::StaticClass();
+	}
+
+	// Restores are measured from memory, the way players come back after a map change
+	IConsoleVariable* WriteToDisk = IConsoleManager::Get().FindConsoleVariable(TEXT("PlayerSnapshot.WriteToDisk"));
+	const int32 PreviousWriteToDisk = WriteToDisk ? WriteToDisk->GetInt() : 0;
+
+	if (WriteToDisk)
+	{
+		WriteToDisk->Set(0, ECVF_SetByCode);
+	}
+
+	ON_SCOPE_EXIT
+	{
+		if (WriteToDisk)
+		{
+			WriteToDisk->Set(PreviousWriteToDisk, ECVF_SetByCode);
+		}
+	};
+
+	FActionGameTestWorld TestWorld;
+
+	UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+	UPlayerSnapshotSubsystem* PlayerSnapshots = NewObject<UPlayerSnapshotSubsystem>(GameInstance);
+
+	TArray<AActionGameCharacter*> Characters;
+
+	for (int32 PlayerIndex = 0; PlayerIndex < NumPlayers; ++PlayerIndex)
+	{
+		AActionGameCharacter* Character = TestWorld.World->SpawnActor<AActionGameCharacter>(FVector(PlayerIndex * 200.f, 0.f, 0.f), FRotator::ZeroRotator);
+		APlayerState* PlayerState = TestWorld.World->SpawnActor<APlayerState>();
+		UInventoryComponent* Inventory = Character ? Character->GetInventoryComponent() : nullptr;
+
+		if (!Inventory || !PlayerState)
+		{
+			AddError(FString::Printf(TEXT("Could not spawn player %d with an inventory"), PlayerIndex));
+			return false;
+		}
+
+		PlayerState->SetPlayerName(FString::Printf(TEXT("SnapshotBenchmarkPlayer%d"), PlayerIndex));
+		Character->SetPlayerState(PlayerState);
+
+		for (const TSubclassOf<UItemStaticData>& WeaponClass : WeaponClasses)
+		{
+			Inventory->AddItem(WeaponClass);
+		}
+
+		for (int32 ItemIndex = 0; ItemIndex < NumTestItemsPerPlayer; ++ItemIndex)
+		{
+			Inventory->AddItem(TestItemClass);
+		}
+
+		Inventory->EquipItem(WeaponClasses[PlayerIndex % WeaponClasses.Num()]);
+
+		PlayerSnapshots->SavePlayer(Character);
+
+		Characters.Add(Character);
+	}
+
+	// The first restore loads the item classes and their actors, a map change finds them already loaded
+	PlayerSnapshots->RestorePlayer(Characters[0]);
+
+	double TotalSeconds = 0.;
+	double WorstSeconds = 0.;
+
+	for (AActionGameCharacter* Character : Characters)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		const bool bRestored = PlayerSnapshots->RestorePlayer(Character);
+
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		TotalSeconds += Seconds;
+		WorstSeconds = FMath::Max(WorstSeconds, Seconds);
+
+		UInventoryComponent* Inventory = Character->GetInventoryComponent();
+
+		TestTrue(TEXT("The saved snapshot is restored from memory"), bRestored);
+		TestEqual(TEXT("Every item is restored"), Inventory->GetInventoryList().GetItems().Num(), WeaponClasses.Num() + NumTestItemsPerPlayer);
+		TestTrue(TEXT("The equipped weapon is equipped again"), Inventory->GetEquippedItem() != nullptr);
+	}
+
+	PlayerSnapshots->Deinitialize();
+
+	AddInfo(FString::Printf(TEXT("Restored %d players in %.3f ms, %.3f ms on average and %.3f ms at worst against a %.3f ms budget"),
+		NumPlayers, TotalSeconds * 1000., TotalSeconds * 1000. / NumPlayers, WorstSeconds * 1000., RestoreBudgetSeconds * 1000.));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActionGameCharacter.h"
+#include "ActionGameTypes.h"
+#include "ActorComponents/InventoryComponent.h"
+#include "Inventory/InventoryItemInstance.h"
+#include "Inventory/InventoryList.h"
+#include "AbilitySystemComponent.h"
+#include "AttributeSet.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/ActionGameTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAttributeSetSubObjectsTest, "ActionGame.Replication.AttributeSetsRegistered", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FAttributeSetSubObjectsTest::RunTest(const FString& Parameters)
+{
+	FActionGameTestWorld TestWorld;
+
+	AActionGameCharacter* Character = TestWorld.World->SpawnActor<AActionGameCharacter>();
+
+	if (!Character)
+	{
+		AddError(TEXT("Could not spawn a character"));
+		return false;
+	}
+
+	// Once the character uses the registered list, the legacy ReplicateSubobjects of its components is never called
+	TestTrue(TEXT("The character replicates through the registered subobject list"), Character->IsUsingRegisteredSubObjectList());
+
+	UAbilitySystemComponent* AbilitySystemComponent = Character->GetAbilitySystemComponent();
+
+	if (!AbilitySystemComponent)
+	{
+		AddError(TEXT("The character has no ability system component"));
+		return false;
+	}
+
+	TestTrue(TEXT("The ability system component replicates through the registered subobject list"), AbilitySystemComponent->IsUsingRegisteredSubObjectList());
+
+	const TArray<UAttributeSet*>& AttributeSets = AbilitySystemComponent->GetSpawnedAttributes();
+
+	TestTrue(TEXT("The character has attribute sets"), AttributeSets.Num() > 0);
+
+	for (const UAttributeSet* AttributeSet : AttributeSets)
+	{
+		TestTrue(FString::Printf(TEXT("%s is a registered subobject of the ability system component"), *GetNameSafe(AttributeSet)), AbilitySystemComponent->IsReplicatedSubObjectRegistered(AttributeSet));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInventorySubObjectsRegisteredTest, "ActionGame.Replication.Inventory100PlayersRegistered", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInventorySubObjectsRegisteredTest::RunTest(const FString& Parameters)
+{
+	static const int32 NumPlayers = 100;
+	static const int32 NumItemsPerPlayer = 10;
+
+	FActionGameTestWorld TestWorld;
+
+	for (int32 PlayerIndex = 0; PlayerIndex < NumPlayers; ++PlayerIndex)
+	{
+		AActionGameCharacter* Character = TestWorld.World->SpawnActor<AActionGameCharacter>(FVector(PlayerIndex * 200.f, 0.f, 0.f), FRotator::ZeroRotator);
+		UInventoryComponent* Inventory = Character ? Character->GetInventoryComponent() : nullptr;
+
+		if (!Inventory)
+		{
+			AddError(FString::Printf(TEXT("Could not spawn player %d with an inventory"), PlayerIndex));
+			return false;
+		}
+
+		TestTrue(TEXT("The inventory replicates through the registered subobject list"), Inventory->IsUsingRegisteredSubObjectList());
+
+		for (int32 ItemIndex = 0; ItemIndex < NumItemsPerPlayer; ++ItemIndex)
+		{
+			Inventory->AddItem(UItemStaticData::StaticClass());
+		}
+
+		const TArray<FInventoryListItem>& Items = Inventory->GetInventoryList().GetItems();
+
+		TestEqual(TEXT("Every item has an entry"), Items.Num(), NumItemsPerPlayer);
+
+		for (const FInventoryListItem& Item : Items)
+		{
+			TestTrue(TEXT("Carried items are registered subobjects of the inventory"), Inventory->IsReplicatedSubObjectRegistered(Item.ItemInstance));
+		}
+	}
+
+	return true;
+}
+
+#endif
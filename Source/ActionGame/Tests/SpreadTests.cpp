@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActionGameStatics.h"
+#include "ActionGameTypes.h"
+#include "GameplayPrediction.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpreadDeterminismTest, "ActionGame.Weapons.SpreadDeterminism", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FSpreadDeterminismTest::RunTest(const FString& Parameters)
+{
+	// The server re-applies the shot's spread from its seed, any difference from the client's result rejects the hit
+	UWeaponStaticData* WeaponData = NewObject<UWeaponStaticData>(GetTransientPackage());
+	WeaponData->SpreadAngle = 6.f;
+	WeaponData->PelletCount = 8;
+
+	FPredictionKey PredictionKey;
+	PredictionKey.Current = 42;
+
+	const FVector AimDirection = FVector(1.f, 0.5f, -0.25f).GetSafeNormal();
+
+	constexpr int32 ShotCount = 64;
+
+	auto EvaluateShots = [&]()
+	{
+		TArray<FVector> Directions;
+
+		for (int32 ShotIndex = 0; ShotIndex < ShotCount; ++ShotIndex)
+		{
+			TArray<FVector> PelletDirections;
+			UActionGameStatics::GetWeaponSpreadDirections(WeaponData, AimDirection, UActionGameStatics::MakeShotSeed(PredictionKey, ShotIndex), PelletDirections);
+
+			Directions.Append(PelletDirections);
+		}
+
+		return Directions;
+	};
+
+	const TArray<FVector> Directions = EvaluateShots();
+
+	TestEqual(TEXT("Every pellet of every shot has a direction"), Directions.Num(), ShotCount * WeaponData->PelletCount);
+
+	// Rebuilding the table, as another process does at startup, must reproduce it bit for bit
+	UActionGameStatics::InitializeSpreadTable();
+
+	const TArray<FVector> RebuiltDirections = EvaluateShots();
+
+	TestTrue(TEXT("The rebuilt spread table gives identical directions"), Directions.Num() == RebuiltDirections.Num() && FMemory::Memcmp(Directions.GetData(), RebuiltDirections.GetData(), Directions.Num() * sizeof(FVector)) == 0);
+
+	const float MaxAngleCos = FMath::Cos(FMath::DegreesToRadians(WeaponData->SpreadAngle + 0.01f));
+
+	for (int32 ShotIndex = 0; ShotIndex < ShotCount; ++ShotIndex)
+	{
+		const int32 ShotSeed = UActionGameStatics::MakeShotSeed(PredictionKey, ShotIndex);
+
+		TestEqual(TEXT("A shot seed only depends on the prediction key and shot index"), ShotSeed, UActionGameStatics::MakeShotSeed(PredictionKey, ShotIndex));
+
+		for (int32 PelletIndex = 0; PelletIndex < WeaponData->PelletCount; ++PelletIndex)
+		{
+			const FVector& Direction = Directions[ShotIndex * WeaponData->PelletCount + PelletIndex];
+
+			// What the server evaluates for a single pellet it validates
+			TestTrue(TEXT("A single pellet evaluates like the whole shot"), Direction == UActionGameStatics::GetWeaponSpreadDirection(WeaponData, AimDirection, ShotSeed, PelletIndex));
+
+			TestTrue(TEXT("Pellets stay inside the spread cone"), (Direction | AimDirection) >= MaxAngleCos);
+
+			for (int32 OtherPelletIndex = 0; OtherPelletIndex < PelletIndex; ++OtherPelletIndex)
+			{
+				TestFalse(TEXT("Pellets of a shot take different directions"), Direction == Directions[ShotIndex * WeaponData->PelletCount + OtherPelletIndex]);
+			}
+		}
+	}
+
+	// Without spread every pellet flies along the aim
+	WeaponData->SpreadAngle = 0.f;
+
+	TestTrue(TEXT("No spread keeps the aim"), UActionGameStatics::GetWeaponSpreadDirection(WeaponData, AimDirection, 1234, 3).Equals(AimDirection));
+
+	return true;
+}
+
+#endif
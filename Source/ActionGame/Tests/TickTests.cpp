@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActorComponents/InventoryComponent.h"
+#include "Actors/ItemActor.h"
+#include "Volumes/AbilitySystemPhysicsVolume.h"
+#include "GameFramework/Character.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/ActionGameTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNoTickDefaultsTest, "ActionGame.Tick.NoTickDefaults", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNoTickDefaultsTest::RunTest(const FString& Parameters)
+{
+	// These draw their debug through the debug draw subsystem, a tick coming back costs one per inventory, item and volume
+	TestFalse(TEXT("UInventoryComponent never ticks"), GetDefault<UInventoryComponent>()->PrimaryComponentTick.bCanEverTick);
+	TestFalse(TEXT("AItemActor never ticks"), GetDefault<AItemActor>()->PrimaryActorTick.bCanEverTick);
+	TestFalse(TEXT("AAbilitySystemPhysicsVolume never ticks"), GetDefault<AAbilitySystemPhysicsVolume>()->PrimaryActorTick.bCanEverTick);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNoTickSpawnedTest, "ActionGame.Tick.NoTickSpawned", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FNoTickSpawnedTest::RunTest(const FString& Parameters)
+{
+	// Blueprint subclasses can turn a tick back on in their defaults, so the shipped ones are spawned and checked after begin play
+	static const TCHAR* ItemActorClassPaths[] =
+	{
+		TEXT("/Game/Blueprints/Inventory/Items/BP_WeaponActor.BP_WeaponActor_C"),
+		TEXT("/Game/Blueprints/Inventory/Items/BP_TestItem.BP_TestItem_C"),
+	};
+
+	static const TCHAR* CharacterClassPath = TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter.BP_ThirdPersonCharacter_C");
+
+	FActionGameTestWorld TestWorld;
+
+	TArray<UClass*> ItemActorClasses;
+	ItemActorClasses.Add(AItemActor::StaticClass());
+
+	for (const TCHAR* ItemActorClassPath : ItemActorClassPaths)
+	{
+		if (UClass* ItemActorClass = LoadClass<AItemActor>(nullptr, ItemActorClassPath))
+		{
+			ItemActorClasses.Add(ItemActorClass);
+		}
+		else
+		{
+			AddError(FString::Printf(TEXT("Could not load %s"), ItemActorClassPath));
+		}
+	}
+
+	for (UClass* ItemActorClass : ItemActorClasses)
+	{
+		AActor* ItemActor = TestWorld.World->SpawnActor(ItemActorClass);
+
+		if (!ItemActor)
+		{
+			AddError(FString::Printf(TEXT("Could not spawn %s"), *GetNameSafe(ItemActorClass)));
+			continue;
+		}
+
+		TestFalse(FString::Printf(TEXT("%s has no registered tick"), *GetNameSafe(ItemActorClass)), ItemActor->PrimaryActorTick.IsTickFunctionRegistered());
+	}
+
+	if (AActor* Volume = TestWorld.World->SpawnActor<AAbilitySystemPhysicsVolume>())
+	{
+		TestFalse(TEXT("AAbilitySystemPhysicsVolume has no registered tick"), Volume->PrimaryActorTick.IsTickFunctionRegistered());
+	}
+	else
+	{
+		AddError(TEXT("Could not spawn AAbilitySystemPhysicsVolume"));
+	}
+
+	// The character ticks for movement, only its inventory is expected to stay off the tick list
+	UClass* CharacterClass = LoadClass<ACharacter>(nullptr, CharacterClassPath);
+
+	if (AActor* Character = CharacterClass ? TestWorld.World->SpawnActor(CharacterClass) : nullptr)
+	{
+		TArray<UInventoryComponent*> Inventories;
+		Character->GetComponents(Inventories);
+
+		TestTrue(TEXT("The character has an inventory"), Inventories.Num() > 0);
+
+		for (const UInventoryComponent* Inventory : Inventories)
+		{
+			TestFalse(TEXT("The character's inventory has no registered tick"), Inventory->PrimaryComponentTick.IsTickFunctionRegistered());
+		}
+	}
+	else
+	{
+		AddError(FString::Printf(TEXT("Could not spawn %s"), CharacterClassPath));
+	}
+
+	return true;
+}
+
+#endif
@@ -6,10 +6,32 @@
 #include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
 #include "DrawDebugHelpers.h"
+#include "Subsystems/DebugDrawSubsystem.h"
 
 AAbilitySystemPhysicsVolume::AAbilitySystemPhysicsVolume()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bCanEverTick = false;
+}
+
+void AAbilitySystemPhysicsVolume::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Registered either way, so turning bDrawDebug on while playing still draws
+	if (UDebugDrawSubsystem* DebugDraw = GetWorld()->GetSubsystem<UDebugDrawSubsystem>())
+	{
+		DebugDraw->RegisterDebugDraw(this, nullptr, FOnDebugDraw::CreateUObject(this, &AAbilitySystemPhysicsVolume::DrawDebugVolume), bDrawDebug);
+	}
+}
+
+void AAbilitySystemPhysicsVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UDebugDrawSubsystem* DebugDraw = GetWorld()->GetSubsystem<UDebugDrawSubsystem>())
+	{
+		DebugDraw->UnregisterDebugDraw(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AAbilitySystemPhysicsVolume::ActorEnteredVolume(class AActor* Other)
@@ -110,12 +132,34 @@ void AAbilitySystemPhysicsVolume::ActorLeavingVolume(class AActor* Other)
 	}
 }
 
-void AAbilitySystemPhysicsVolume::Tick(float DeltaSeconds)
+void AAbilitySystemPhysicsVolume::SetDrawDebug(bool bInDrawDebug)
 {
-	Super::Tick(DeltaSeconds);
+	bDrawDebug = bInDrawDebug;
 
-	if (bDrawDebug)
+	UWorld* World = GetWorld();
+
+	if (UDebugDrawSubsystem* DebugDraw = World ? World->GetSubsystem<UDebugDrawSubsystem>() : nullptr)
 	{
-		DrawDebugBox(GetWorld(), GetActorLocation(), GetBounds().BoxExtent, FColor::Red, false, 0, 0, 5);
+		DebugDraw->SetDebugDrawEnabled(this, bDrawDebug);
 	}
 }
+
+#if WITH_EDITOR
+void AAbilitySystemPhysicsVolume::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Editing the volume while playing in editor changes the property without the setter
+	if (PropertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(AAbilitySystemPhysicsVolume, bDrawDebug))
+	{
+		SetDrawDebug(bDrawDebug);
+	}
+}
+#endif
+
+void AAbilitySystemPhysicsVolume::DrawDebugVolume() const
+{
+	if (!bDrawDebug) return;
+
+	DrawDebugBox(GetWorld(), GetActorLocation(), GetBounds().BoxExtent, FColor::Red, false, 0, 0, 5);
+}
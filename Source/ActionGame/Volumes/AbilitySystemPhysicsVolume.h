@@ -34,7 +34,7 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	TArray<TSubclassOf<UGameplayEffect>> OnExitEffectsToApply;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, BlueprintSetter = SetDrawDebug)
 	bool bDrawDebug = false;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
@@ -59,5 +59,17 @@ public:
 
 	virtual void ActorLeavingVolume(class AActor* Other) override;
 
-	virtual void Tick(float DeltaSeconds) override;
+	UFUNCTION(BlueprintSetter)
+	void SetDrawDebug(bool bInDrawDebug);
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	void DrawDebugVolume() const;
 };